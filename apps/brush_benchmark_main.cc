@@ -0,0 +1,128 @@
+#include <core/brush_canvas.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+DEFINE_int32(strokes, 10000, "Number of random strokes to draw");
+DEFINE_int32(points_per_stroke, 20, "Number of mouse events in each stroke");
+DEFINE_double(step, 3, "Distance in pixels the brush moves between events");
+DEFINE_int32(dimension, 28, "Number of pixels in one row/column");
+DEFINE_double(brush_radius, 1.15, "Brush radius in pixels");
+DEFINE_uint64(seed, 0, "Seed of the random strokes");
+
+const double kPi = 3.14159265358979323846;
+
+/**
+ * Shades every pixel within the brush radius of one point by checking the
+ * whole canvas, the way the sketchpad used to on every mouse event.
+ */
+void StampWholeCanvas(naivebayes::Image& image, double x, double y) {
+  for (size_t row = 0; row < image.size(); ++row) {
+    for (size_t col = 0; col < image.size(); ++col) {
+      double offset_x = col + .5 - x;
+      double offset_y = row + .5 - y;
+      if (std::sqrt(offset_x * offset_x + offset_y * offset_y) <=
+          FLAGS_brush_radius) {
+        image[row][col] = '#';
+      }
+    }
+  }
+}
+
+/**
+ * @return the number of shaded pixels in the image.
+ */
+size_t CountShaded(const naivebayes::Image& image) {
+  size_t count = 0;
+  for (const std::vector<char>& row : image) {
+    for (char pixel : row) {
+      count += pixel != ' ';
+    }
+  }
+  return count;
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  // Random walks that bounce off the edges of the canvas.
+  std::mt19937_64 generator(FLAGS_seed);
+  std::uniform_real_distribution<double> position(0, FLAGS_dimension);
+  std::uniform_real_distribution<double> turn(-.5, .5);
+  std::vector<std::vector<double>> strokes_x(FLAGS_strokes);
+  std::vector<std::vector<double>> strokes_y(FLAGS_strokes);
+
+  for (int stroke = 0; stroke < FLAGS_strokes; stroke++) {
+    double x = position(generator);
+    double y = position(generator);
+    double angle = turn(generator) * 4 * kPi;
+
+    for (int point = 0; point < FLAGS_points_per_stroke; point++) {
+      strokes_x[stroke].push_back(x);
+      strokes_y[stroke].push_back(y);
+      angle += turn(generator);
+      x += FLAGS_step * std::cos(angle);
+      y += FLAGS_step * std::sin(angle);
+      if (x < 0 || x > FLAGS_dimension) {
+        angle = kPi - angle;
+        x = std::min(std::max(x, 0.0), (double) FLAGS_dimension);
+      }
+      if (y < 0 || y > FLAGS_dimension) {
+        angle = -angle;
+        y = std::min(std::max(y, 0.0), (double) FLAGS_dimension);
+      }
+    }
+  }
+
+  size_t event_count = (size_t) FLAGS_strokes * FLAGS_points_per_stroke;
+  size_t scan_shaded = 0;
+  size_t brush_shaded = 0;
+  size_t brush_visited = 0;
+
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  for (int stroke = 0; stroke < FLAGS_strokes; stroke++) {
+    naivebayes::Image image(FLAGS_dimension,
+                            std::vector<char>(FLAGS_dimension, ' '));
+    for (int point = 0; point < FLAGS_points_per_stroke; point++) {
+      StampWholeCanvas(image, strokes_x[stroke][point],
+                       strokes_y[stroke][point]);
+    }
+    scan_shaded += CountShaded(image);
+  }
+  double scan_time = std::chrono::duration<double, std::micro>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+
+  start = std::chrono::steady_clock::now();
+  for (int stroke = 0; stroke < FLAGS_strokes; stroke++) {
+    naivebayes::BrushCanvas canvas(FLAGS_dimension, FLAGS_brush_radius);
+    canvas.StartStroke(strokes_x[stroke][0], strokes_y[stroke][0]);
+    for (int point = 1; point < FLAGS_points_per_stroke; point++) {
+      canvas.ContinueStroke(strokes_x[stroke][point], strokes_y[stroke][point]);
+    }
+    brush_shaded += CountShaded(canvas.GetImage());
+    brush_visited += canvas.GetVisitedPixelCount();
+  }
+  double brush_time = std::chrono::duration<double, std::micro>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+
+  std::cout << event_count << " brush events, " << FLAGS_step
+            << " pixels apart" << std::endl;
+  std::cout << "Whole canvas stamping: " << scan_time / event_count
+            << " us/event, " << FLAGS_dimension * FLAGS_dimension
+            << " pixels checked/event, " << scan_shaded << " pixels shaded"
+            << std::endl;
+  std::cout << "Interpolated strokes:  " << brush_time / event_count
+            << " us/event, " << (double) brush_visited / event_count
+            << " pixels checked/event, " << brush_shaded << " pixels shaded ("
+            << brush_shaded - scan_shaded << " gap pixels filled)"
+            << std::endl;
+  return 0;
+}
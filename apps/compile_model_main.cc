@@ -0,0 +1,86 @@
+#include <core/basic_training_model.h>
+#include <core/input_file.h>
+#include <gflags/gflags.h>
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+DEFINE_string(load, "", "Specify a file path to load probability data from");
+DEFINE_string(output, "",
+              "Specify a file path for the generated C++ header of tables");
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_load.empty() || FLAGS_output.empty()) {
+    std::cerr
+        << "No arguments were provided, or provided arguments are incorrect."
+        << std::endl;
+    return 1;
+  }
+
+  naivebayes::BasicTrainingModel model;
+  naivebayes::InputFile ifs(FLAGS_load);
+  ifs >> model;
+
+  std::ofstream os(FLAGS_output);
+  os << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+  os << "// Generated by compile-model from " << FLAGS_load << "." << std::endl
+     << "// Do not edit; rebuild to regenerate." << std::endl
+     << "#pragma once" << std::endl
+     << "#include <cstddef>" << std::endl
+     << std::endl
+     << "namespace naivebayes {" << std::endl
+     << "namespace static_model {" << std::endl
+     << std::endl
+     << "constexpr size_t kImageDimension = " << model.image_size_ << ";"
+     << std::endl
+     << "constexpr size_t kNumClasses = " << model.num_classes_ << ";"
+     << std::endl
+     << std::endl;
+
+  os << "constexpr size_t kClasses[kNumClasses] = {";
+  for (size_t index = 0; index < model.classes_.size(); index++) {
+    os << (index == 0 ? "" : ", ") << model.classes_[index];
+  }
+  os << "};" << std::endl << std::endl;
+
+  os << "// log10 of each class probability." << std::endl
+     << "constexpr double kLogClassProbabilities[kNumClasses] = {" << std::endl;
+  for (size_t class_num : model.classes_) {
+    os << "    " << log10(model.GetClassProbability(class_num)) << ","
+       << std::endl;
+  }
+  os << "};" << std::endl << std::endl;
+
+  // Indexed by class, row, column and then shade.
+  os << "// log10 of each pixel probability, indexed [class][row][col][shade]."
+     << std::endl
+     << "constexpr double kLogPixelProbabilities[kNumClasses][kImageDimension]"
+        "[kImageDimension][2] = {"
+     << std::endl;
+  for (size_t class_num : model.classes_) {
+    os << "    {" << std::endl;
+    for (size_t row = 0; row < model.image_size_; row++) {
+      os << "        {";
+      for (size_t col = 0; col < model.image_size_; col++) {
+        os << "{" << log10(model.GetPixelProbability(class_num, 0, row, col))
+           << ", " << log10(model.GetPixelProbability(class_num, 1, row, col))
+           << "}, ";
+      }
+      os << "}," << std::endl;
+    }
+    os << "    }," << std::endl;
+  }
+  os << "};" << std::endl
+     << std::endl
+     << "}  // namespace static_model" << std::endl
+     << "}  // namespace naivebayes" << std::endl;
+
+  std::cout << "Tables successfully generated." << std::endl;
+  return 0;
+}
@@ -0,0 +1,53 @@
+#include <core/basic_training_model.h>
+#include <core/dataset_generator.h>
+#include <core/input_file.h>
+#include <gflags/gflags.h>
+
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+DEFINE_string(load, "", "Specify a file path to load probability data from");
+DEFINE_string(images, "", "Specify a file path to write the images to");
+DEFINE_string(labels, "", "Specify a file path to write the labels to");
+DEFINE_uint64(count, 0, "Number of images to generate");
+DEFINE_uint64(seed, 0, "Seed that makes the generated dataset reproducible");
+DEFINE_string(format, "ascii", "Format of the image file: ascii or packed");
+DEFINE_int32(threads, 0,
+             "Number of generating threads, or 0 for one per hardware thread");
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_load.empty() || FLAGS_images.empty() || FLAGS_labels.empty() ||
+      FLAGS_count == 0) {
+    std::cout
+        << "No arguments were provided, or provided arguments are incorrect."
+        << std::endl;
+    return 1;
+  }
+  if (FLAGS_format != "ascii" && FLAGS_format != "packed") {
+    std::cerr << "--format must be ascii or packed, not " << FLAGS_format
+              << "." << std::endl;
+    return 1;
+  }
+
+  naivebayes::BasicTrainingModel model;
+  naivebayes::InputFile ifs(FLAGS_load);
+  ifs >> model;
+
+  size_t threads = FLAGS_threads > 0 ? FLAGS_threads
+                                     : std::thread::hardware_concurrency();
+  naivebayes::DatasetGenerator generator(model, FLAGS_seed,
+                                         threads == 0 ? 1 : threads);
+  naivebayes::ImageFormat format = FLAGS_format == "packed"
+                                       ? naivebayes::ImageFormat::kPacked
+                                       : naivebayes::ImageFormat::kAscii;
+
+  std::ofstream images_stream(FLAGS_images, std::ios::binary);
+  std::ofstream labels_stream(FLAGS_labels);
+  generator.Generate(FLAGS_count, format, images_stream, labels_stream);
+
+  std::cout << FLAGS_count << " images successfully generated." << std::endl;
+  return 0;
+}
@@ -0,0 +1,57 @@
+#include <core/basic_training_model.h>
+#include <core/input_file.h>
+#include <core/count_snapshot.h>
+#include <gflags/gflags.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+DEFINE_string(counts, "",
+              "Specify a comma separated list of count snapshot file paths");
+DEFINE_string(save, "", "Specify a file path to save the merged model to");
+DEFINE_string(save_counts, "",
+              "Specify a file path to save the merged counts to");
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (FLAGS_counts.empty() || (FLAGS_save.empty() && FLAGS_save_counts.empty())) {
+    std::cout
+        << "No arguments were provided, or provided arguments are incorrect."
+        << std::endl;
+    return 1;
+  }
+
+  // Merging is a sum, so the snapshots can be listed in any order.
+  naivebayes::CountSnapshot merged;
+  std::stringstream file_paths(FLAGS_counts);
+  std::string file_path;
+  size_t snapshot_count = 0;
+
+  while (std::getline(file_paths, file_path, ',')) {
+    naivebayes::CountSnapshot counts;
+    naivebayes::InputFile ifs(file_path);
+    ifs >> counts;
+    merged.Merge(counts);
+    snapshot_count++;
+  }
+  std::cout << "Merged " << snapshot_count << " snapshots of "
+            << merged.GetImageCount() << " images." << std::endl;
+
+  if (!FLAGS_save_counts.empty()) {
+    std::ofstream ofs(FLAGS_save_counts);
+    ofs << merged;
+    std::cout << "Counts successfully saved." << std::endl;
+  }
+
+  if (!FLAGS_save.empty()) {
+    naivebayes::BasicTrainingModel model;
+    model.TrainModel(merged);
+    std::ofstream ofs(FLAGS_save);
+    ofs << model;
+    std::cout << "Data successfully saved." << std::endl;
+  }
+
+  return 0;
+}
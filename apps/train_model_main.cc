@@ -1,47 +1,306 @@
+#include <core/allocation_tracker.h>
+#include <core/bagged_ensemble.h>
 #include <core/basic_training_model.h>
+#include <core/batch_runner.h>
+#include <core/cascade_classifier.h>
+#include <core/classification_cache.h>
 #include <core/classifier.h>
+#include <core/input_file.h>
+#include <core/pipelined_evaluator.h>
+#include <core/quantized_model.h>
+#include <core/stream_classifier.h>
 #include <gflags/gflags.h>
 
+#include <chrono>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
 
 DEFINE_string(read_images, "", "Specify a file path for the training images");
 DEFINE_string(read_labels, "", "Specify a file path for the training labels");
 DEFINE_string(save, "", "Specify a file path to load probability data to");
 DEFINE_string(load, "", "Specify a file path to load probability data from");
+DEFINE_string(save_counts, "",
+              "Specify a file path to save the training counts to, so they "
+              "can be merged with other shards by merge-counts");
+DEFINE_int32(shift_augmentation, 0,
+             "Also count every training image shifted by up to this many "
+             "pixels in each direction");
 DEFINE_string(read_test_images, "",
               "Specify a file path for the testing images");
 DEFINE_string(read_test_labels, "",
               "Specify a file path for the testing labels");
+DEFINE_int32(quantize_bits, 0,
+             "Also evaluate an 8 or 16 bit quantized copy of the model");
+DEFINE_int32(pipeline_threads, 0,
+             "Also evaluate the test files with a parse/classify pipeline "
+             "using this many classifying threads");
+DEFINE_int32(pipeline_block_size, 64,
+             "Number of images in each block passed through the pipeline");
+DEFINE_bool(evaluation_report, false,
+            "Also stream the test files through the pipeline and print a "
+            "confusion matrix, per class precision and recall, top-k "
+            "accuracy and a margin histogram");
+DEFINE_int32(top_k, 3, "Largest k whose top-k accuracy is reported");
+DEFINE_int32(bagging_replicas, 0,
+             "Also train and evaluate a bagged ensemble of this many models");
+DEFINE_int32(bagging_seed, 0, "Seed for the bagged ensemble's bootstrap");
+DEFINE_string(cascade_factors, "",
+              "Also evaluate a cascade whose early levels are downsampled by "
+              "these comma separated factors, coarsest first");
+DEFINE_double(cascade_agreement, .99,
+              "Fraction of early cascade answers that must agree with the "
+              "full resolution model when tuning thresholds");
+DEFINE_int32(cache_capacity, 0,
+             "Also time classifying the test images through a result cache "
+             "holding this many images");
+DEFINE_bool(memory_report, false,
+            "Print the memory used by each stage: parsing, reading labels, "
+            "training, saving, loading and classifying");
+DEFINE_string(classify, "",
+              "Classify every image in this file, or stdin when given -, and "
+              "write one label per line to stdout using the --load model");
+DEFINE_string(classify_format, "ascii",
+              "Format of the images to classify: ascii or packed");
+DEFINE_bool(classify_scores, false,
+            "Follow each label with the likelihood score of every class");
+DEFINE_int32(threads, 0,
+             "Number of classifying threads, or 0 for one per hardware "
+             "thread");
+DEFINE_int32(batch_size, 4096,
+             "Number of images read and classified at a time");
+DEFINE_string(manifest, "",
+              "Run every train and evaluate job listed in this file against "
+              "the --read_images and --read_test_images datasets, parsing "
+              "them once, with --threads jobs at a time");
+DEFINE_string(report, "",
+              "Write the --manifest results to this file instead of stdout");
+
+/**
+ * @return the wall time in milliseconds since start.
+ */
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+/**
+ * Parses a comma separated list of downsampling factors, each a whole number
+ * of at least 1.
+ * @return whether every factor was valid.
+ */
+bool ParseFactors(const std::string& factor_list,
+                  std::vector<size_t>& factors) {
+  std::stringstream factor_stream(factor_list);
+  std::string factor;
+  while (std::getline(factor_stream, factor, ',')) {
+    // std::stoul alone would accept a sign or trailing characters, and
+    // throw out of main on a factor too long to fit.
+    if (factor.empty() || factor.size() > 9 ||
+        factor.find_first_not_of("0123456789") != std::string::npos ||
+        std::stoul(factor) == 0) {
+      return false;
+    }
+    factors.push_back(std::stoul(factor));
+  }
+  return !factors.empty();
+}
+
+/**
+ * Streams images through a loaded model for the --classify mode. Only labels
+ * are written to stdout so the output can be piped; errors go to stderr.
+ */
+int ClassifyStream() {
+  if (FLAGS_load.empty()) {
+    std::cerr << "--classify needs a model given with --load." << std::endl;
+    return 1;
+  }
+  if (FLAGS_classify_format != "ascii" && FLAGS_classify_format != "packed") {
+    std::cerr << "--classify_format must be ascii or packed, not "
+              << FLAGS_classify_format << "." << std::endl;
+    return 1;
+  }
+
+  naivebayes::Classifier classifier;
+  naivebayes::InputFile model_stream(FLAGS_load);
+  model_stream >> classifier.model_;
+
+  size_t threads = FLAGS_threads > 0 ? FLAGS_threads
+                                     : std::thread::hardware_concurrency();
+  naivebayes::StreamClassifier stream_classifier(
+      classifier, threads == 0 ? 1 : threads, FLAGS_batch_size,
+      FLAGS_classify_scores);
+  naivebayes::ImageFormat format = FLAGS_classify_format == "packed"
+                                       ? naivebayes::ImageFormat::kPacked
+                                       : naivebayes::ImageFormat::kAscii;
+
+  std::ios::sync_with_stdio(false);
+  std::cin.tie(nullptr);
+  try {
+    if (FLAGS_classify == "-") {
+      stream_classifier.ClassifyStream(std::cin, format, std::cout);
+    } else {
+      std::ifstream image_stream(FLAGS_classify, std::ios::binary);
+      stream_classifier.ClassifyStream(image_stream, format, std::cout);
+    }
+  } catch (const std::invalid_argument& error) {
+    std::cout.flush();
+    std::cerr << "--classify failed: " << error.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+/**
+ * Runs the jobs of a manifest for the --manifest mode. The datasets are read
+ * once and shared by every job.
+ */
+int RunManifest() {
+  if (FLAGS_read_images.empty() || FLAGS_read_labels.empty()) {
+    std::cerr << "--manifest needs --read_images and --read_labels."
+              << std::endl;
+    return 1;
+  }
+
+  std::vector<naivebayes::BatchJob> jobs;
+  try {
+    std::ifstream manifest_stream(FLAGS_manifest);
+    jobs = naivebayes::BatchRunner::ReadManifest(manifest_stream);
+  } catch (const std::invalid_argument& error) {
+    std::cerr << "--manifest " << FLAGS_manifest << ": " << error.what()
+              << std::endl;
+    return 1;
+  }
+
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  naivebayes::Images training_images;
+  naivebayes::BasicTrainingModel labels_model;
+  // Jobs without a holdout report an error when there is no test set.
+  naivebayes::Images test_images;
+  naivebayes::Classifier labels_classifier;
+  try {
+    naivebayes::InputFile ifs(FLAGS_read_images);
+    ifs >> training_images;
+    labels_model.ReadLabels(FLAGS_read_labels);
+
+    if (!FLAGS_read_test_images.empty() && !FLAGS_read_test_labels.empty()) {
+      naivebayes::InputFile test_ifs(FLAGS_read_test_images);
+      test_ifs >> test_images;
+      labels_classifier.ReadLabels(FLAGS_read_test_labels);
+    }
+  } catch (const std::invalid_argument& error) {
+    std::cerr << "--manifest could not read the datasets: " << error.what()
+              << std::endl;
+    return 1;
+  }
+  std::cout << "Read datasets in " << MillisecondsSince(start) << " ms."
+            << std::endl;
+
+  size_t threads = FLAGS_threads > 0 ? FLAGS_threads
+                                     : std::thread::hardware_concurrency();
+  naivebayes::BatchRunner runner(
+      training_images, labels_model.GetLabels(), test_images,
+      labels_classifier.GetExpectedClasses(), threads == 0 ? 1 : threads);
+
+  start = std::chrono::steady_clock::now();
+  std::vector<naivebayes::BatchResult> results = runner.Run(jobs);
+  std::cout << "Ran " << jobs.size() << " jobs in " << MillisecondsSince(start)
+            << " ms." << std::endl;
+
+  if (FLAGS_report.empty()) {
+    naivebayes::BatchRunner::WriteReport(std::cout, results);
+  } else {
+    std::ofstream report_stream(FLAGS_report);
+    naivebayes::BatchRunner::WriteReport(report_stream, results);
+  }
+  return 0;
+}
 
 int main(int argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
+  if (!FLAGS_classify.empty()) {
+    return ClassifyStream();
+  }
+  if (!FLAGS_manifest.empty()) {
+    return RunManifest();
+  }
+  if (FLAGS_evaluation_report && FLAGS_top_k < 1) {
+    std::cerr << "--top_k must be at least 1." << std::endl;
+    return 1;
+  }
+  std::vector<size_t> cascade_factors;
+  if (!FLAGS_cascade_factors.empty() &&
+      !ParseFactors(FLAGS_cascade_factors, cascade_factors)) {
+    std::cerr << "--cascade_factors must be comma separated whole numbers of "
+                 "at least 1."
+              << std::endl;
+    return 1;
+  }
+
   naivebayes::BasicTrainingModel model;
   naivebayes::Images data;
   naivebayes::Classifier classifier;
+  double training_time = 0;
 
   if (FLAGS_read_images.empty() && FLAGS_read_labels.empty() &&
-      FLAGS_save.empty() && FLAGS_load.empty()) {
+      FLAGS_save.empty() && FLAGS_load.empty() && FLAGS_save_counts.empty()) {
     std::cout
         << "No arguments were provided, or provided arguments are incorrect."
         << std::endl;
   }
 
   if (!FLAGS_read_images.empty() && !FLAGS_read_labels.empty()) {
-    std::ifstream ifs(FLAGS_read_images);
-    ifs >> data;
-    model.SetImages(data);
+    {
+      naivebayes::AllocationTracker::Stage stage("parse");
+      naivebayes::InputFile ifs(FLAGS_read_images);
+      ifs >> data;
+      model.SetImages(std::move(data));
+    }
     std::cout << "Images successfully read." << std::endl;
-    model.ReadLabels(FLAGS_read_labels);
+    {
+      naivebayes::AllocationTracker::Stage stage("labels");
+      model.ReadLabels(FLAGS_read_labels);
+    }
     std::cout << "Labels successfully read." << std::endl;
-    model.TrainModel();
 
-    if (!FLAGS_save.empty()) {
-      std::ofstream ofs(FLAGS_save);
-      ofs << model;
-      std::cout << "Data successfully saved." << std::endl;
+    naivebayes::CountSnapshot counts;
+    {
+      naivebayes::AllocationTracker::Stage stage("train");
+      std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+      if (FLAGS_shift_augmentation > 0) {
+        counts = model.CountImages(naivebayes::CountSnapshot::MakeShifts(
+            FLAGS_shift_augmentation));
+      } else {
+        counts = model.CountImages();
+      }
+      model.TrainModel(counts);
+      training_time = MillisecondsSince(start);
     }
+    std::cout << "Trained on " << counts.GetImageCount() << " images in "
+              << training_time << " ms." << std::endl;
+
+    {
+      naivebayes::AllocationTracker::Stage stage("save");
+      if (!FLAGS_save_counts.empty()) {
+        std::ofstream ofs(FLAGS_save_counts);
+        ofs << counts;
+        std::cout << "Counts successfully saved." << std::endl;
+      }
+
+      if (!FLAGS_save.empty()) {
+        std::ofstream ofs(FLAGS_save);
+        ofs << model;
+        std::cout << "Data successfully saved." << std::endl;
+      }
+    }
+    classifier.SetModel(std::move(model));
 
   } else {
     if (!FLAGS_save.empty()) {
@@ -53,22 +312,183 @@ int main(int argc, char** argv) {
   }
 
   if (!FLAGS_load.empty()) {
-    std::ifstream ifs(FLAGS_load);
+    naivebayes::AllocationTracker::Stage stage("load");
+    naivebayes::InputFile ifs(FLAGS_load);
     ifs >> classifier.model_;
     std::cout << "Data successfully loaded into model." << std::endl;
   }
 
   if (!FLAGS_read_test_images.empty() && !FLAGS_read_test_labels.empty()) {
-    std::ifstream ifs(FLAGS_read_test_images);
-    ifs >> data;
-    classifier.ReadLabels(FLAGS_read_test_labels);
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    naivebayes::Images test_data;
+    {
+      naivebayes::AllocationTracker::Stage stage("test parse");
+      naivebayes::InputFile ifs(FLAGS_read_test_images);
+      ifs >> test_data;
+    }
+    {
+      naivebayes::AllocationTracker::Stage stage("test labels");
+      classifier.ReadLabels(FLAGS_read_test_labels);
+    }
 
-    std::cout << "Accuracy: " << classifier.CalculateAccuracy(data)
-              << std::endl;
+    double accuracy = 0;
+    {
+      naivebayes::AllocationTracker::Stage stage("classify");
+      accuracy = classifier.CalculateAccuracy(test_data);
+    }
+    double sequential_time = MillisecondsSince(start);
+    std::cout << "Accuracy: " << accuracy << std::endl;
+
+    if (FLAGS_pipeline_threads > 0) {
+      start = std::chrono::steady_clock::now();
+      naivebayes::InputFile images_stream(FLAGS_read_test_images);
+      naivebayes::InputFile labels_stream(FLAGS_read_test_labels);
+      naivebayes::PipelinedEvaluator evaluator(
+          classifier, FLAGS_pipeline_threads, FLAGS_pipeline_block_size);
+      double pipelined_accuracy =
+          evaluator.CalculateAccuracy(images_stream, labels_stream);
+      double pipelined_time = MillisecondsSince(start);
+
+      std::cout << "Pipelined accuracy: " << pipelined_accuracy << std::endl;
+      std::cout << "Sequential evaluation: " << sequential_time
+                << " ms, pipelined evaluation with " << FLAGS_pipeline_threads
+                << " classifying threads: " << pipelined_time << " ms"
+                << std::endl;
+    }
+
+    if (FLAGS_evaluation_report) {
+      start = std::chrono::steady_clock::now();
+      naivebayes::InputFile images_stream(FLAGS_read_test_images);
+      naivebayes::InputFile labels_stream(FLAGS_read_test_labels);
+      naivebayes::PipelinedEvaluator evaluator(
+          classifier, FLAGS_pipeline_threads > 0 ? FLAGS_pipeline_threads : 1,
+          FLAGS_pipeline_block_size);
+      naivebayes::EvaluationReport report =
+          evaluator.Evaluate(images_stream, labels_stream, FLAGS_top_k);
+      double report_time = MillisecondsSince(start);
+
+      std::cout << report;
+      std::cout << "Sequential evaluation: " << sequential_time
+                << " ms, streamed report: " << report_time << " ms"
+                << std::endl;
+    }
+
+    if (FLAGS_bagging_replicas > 0 && !FLAGS_read_images.empty()) {
+      start = std::chrono::steady_clock::now();
+      naivebayes::BaggedEnsemble ensemble;
+      ensemble.TrainModels(classifier.model_.GetTrainingImages(),
+                           classifier.model_.GetLabels(),
+                           FLAGS_bagging_replicas, FLAGS_bagging_seed);
+      double ensemble_training_time = MillisecondsSince(start);
+
+      start = std::chrono::steady_clock::now();
+      double ensemble_accuracy = ensemble.CalculateAccuracy(
+          test_data, classifier.GetExpectedClasses());
+      double ensemble_inference_time = MillisecondsSince(start);
+
+      start = std::chrono::steady_clock::now();
+      classifier.CalculateAccuracy(test_data);
+      double inference_time = MillisecondsSince(start);
+
+      std::cout << FLAGS_bagging_replicas
+                << " model bagged accuracy: " << ensemble_accuracy << std::endl;
+      std::cout << "Training: " << ensemble_training_time << " ms ("
+                << ensemble_training_time / training_time
+                << "x one model), inference: " << ensemble_inference_time
+                << " ms (" << ensemble_inference_time / inference_time
+                << "x one model)" << std::endl;
+    }
+
+    if (!cascade_factors.empty() && !FLAGS_read_images.empty()) {
+      naivebayes::CascadeClassifier cascade;
+      cascade.TrainModels(classifier.model_.GetTrainingImages(),
+                          classifier.model_.GetLabels(), cascade_factors);
+      cascade.TuneThresholds(classifier.model_.GetTrainingImages(),
+                             FLAGS_cascade_agreement);
+
+      start = std::chrono::steady_clock::now();
+      double cascade_accuracy = cascade.CalculateAccuracy(
+          test_data, classifier.GetExpectedClasses());
+      double cascade_time = MillisecondsSince(start);
+
+      start = std::chrono::steady_clock::now();
+      for (const naivebayes::Image& image : test_data.GetImages()) {
+        cascade.GetFullClassifier().ClassifyImage(image);
+      }
+      double full_time = MillisecondsSince(start);
+
+      std::cout << "Cascade accuracy: " << cascade_accuracy << ", resolved early: "
+                << cascade.GetEarlyFraction() << std::endl;
+      std::cout << "Cascade: " << cascade_time << " ms, full resolution: "
+                << full_time << " ms (" << full_time / cascade_time
+                << "x throughput)" << std::endl;
+    }
+
+    if (FLAGS_cache_capacity > 0) {
+      const std::vector<naivebayes::Image>& images = test_data.GetImages();
+      naivebayes::ClassificationCache cache(classifier, FLAGS_cache_capacity);
+
+      start = std::chrono::steady_clock::now();
+      for (const naivebayes::Image& image : images) {
+        classifier.ClassifyImage(image);
+      }
+      double uncached_time = MillisecondsSince(start) * 1000 / images.size();
+
+      // The first pass fills the cache, the second should only hit.
+      start = std::chrono::steady_clock::now();
+      for (const naivebayes::Image& image : images) {
+        cache.ClassifyImage(image);
+      }
+      double miss_time = MillisecondsSince(start) * 1000 / images.size();
+      size_t first_pass_hits = cache.GetHits();
+
+      start = std::chrono::steady_clock::now();
+      for (const naivebayes::Image& image : images) {
+        cache.ClassifyImage(image);
+      }
+      double hit_time = MillisecondsSince(start) * 1000 / images.size();
+
+      std::cout << "Uncached: " << uncached_time
+                << " us/image, cold cache: " << miss_time << " us/image ("
+                << first_pass_hits << " hits), warm cache: " << hit_time
+                << " us/image (" << cache.GetHits() - first_pass_hits
+                << " hits, " << cache.GetMisses() << " misses in total)"
+                << std::endl;
+    }
+
+    if (FLAGS_quantize_bits != 0) {
+      // Calibrates on the training images when they were read, so the test
+      // set stays unseen.
+      naivebayes::QuantizedModel quantized;
+      double scale = quantized.Calibrate(
+          classifier.model_,
+          FLAGS_read_images.empty() ? test_data
+                                     : classifier.model_.GetTrainingImages(),
+          FLAGS_quantize_bits);
+      double quantized_accuracy = quantized.CalculateAccuracy(
+          test_data, classifier.GetExpectedClasses());
+      size_t float_bytes =
+          classifier.model_.GetProbabilities().size() * sizeof(double);
+
+      std::cout << FLAGS_quantize_bits << " bit quantized accuracy: "
+                << quantized_accuracy << " (delta "
+                << quantized_accuracy - accuracy << ", scale " << scale << ")"
+                << std::endl;
+      std::cout << "Model footprint: " << float_bytes << " bytes -> "
+                << quantized.GetFootprintBytes() << " bytes ("
+                << (double) float_bytes / quantized.GetFootprintBytes()
+                << "x smaller)" << std::endl;
+    }
   } else if (!FLAGS_read_test_images.empty() ||
              !FLAGS_read_test_labels.empty()) {
     std::cout << "A test file was missing." << std::endl;
   }
 
+  if (FLAGS_memory_report) {
+    std::cout << "Memory by stage:" << std::endl;
+    naivebayes::AllocationTracker::WriteReport(std::cout);
+  }
+
   return 0;
 }
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace naivebayes {
+
+/**
+ * Counts heap allocations and attributes them to named stages such as
+ * parsing, training or classifying.
+ *
+ * The counting itself is opt-in: only programs linked with
+ * src/core/allocation_hooks.cc, which replaces the global operator new and
+ * operator delete, report allocations. Configure with
+ * -DNAIVEBAYES_TRACK_ALLOCATIONS=ON to link it into train-model. Without
+ * the hooks every stage still records the process's peak resident set size.
+ */
+class AllocationTracker {
+ public:
+  /**
+   * What happened to the heap while one stage was open. Allocations made by
+   * nested stages are included in the enclosing stage too.
+   */
+  struct StageStats {
+    std::string name;
+    size_t allocations;
+    size_t allocated_bytes;
+    size_t freed_bytes;
+
+    // Most bytes live at once above what was live when the stage opened.
+    size_t peak_live_bytes;
+
+    // Peak resident set size of the process when the stage closed.
+    size_t peak_resident_bytes;
+  };
+
+  /**
+   * Opens a stage for as long as it is in scope and records its statistics
+   * when it is destroyed.
+   */
+  class Stage {
+   public:
+    explicit Stage(const std::string& name);
+
+    ~Stage();
+
+    Stage(const Stage&) = delete;
+    Stage& operator=(const Stage&) = delete;
+
+   private:
+    std::string name_;
+    size_t start_allocations_;
+    size_t start_allocated_bytes_;
+    size_t start_freed_bytes_;
+    size_t start_live_bytes_;
+    size_t outer_peak_live_bytes_;
+  };
+
+  /**
+   * Called by the allocation hooks for every allocation and deallocation.
+   * Both are lock free and never allocate.
+   */
+  static void RecordAllocation(size_t bytes);
+  static void RecordDeallocation(size_t bytes);
+
+  /**
+   * @return whether any allocation has been recorded, which is only the case
+   * when the allocation hooks are linked in.
+   */
+  static bool IsCounting();
+
+  /**
+   * @return the statistics of every closed stage, in the order they closed.
+   */
+  static std::vector<StageStats> GetStages();
+
+  /**
+   * Forgets every closed stage.
+   */
+  static void ClearStages();
+
+  /**
+   * @return the most memory the process has had resident so far, in bytes,
+   * or 0 where the platform does not report it.
+   */
+  static size_t GetPeakResidentBytes();
+
+  /**
+   * Writes one line per closed stage with its allocation count, bytes
+   * allocated, freed and peak live, and the peak resident set size.
+   */
+  static void WriteReport(std::ostream& os);
+};
+
+}  // namespace naivebayes
@@ -0,0 +1,91 @@
+#pragma once
+#include <core/images.h>
+
+#include <vector>
+
+namespace naivebayes {
+
+/**
+ * A bootstrap aggregated ensemble of Naive Bayes models.
+ *
+ * Instead of drawing a resampled copy of the training set for each replica,
+ * every training image is folded into each replica's counts with a Poisson(1)
+ * weight, which is the online equivalent of sampling with replacement. All
+ * replicas are trained in a single pass over the data.
+ */
+class BaggedEnsemble {
+ public:
+  /**
+   * Trains num_replicas bootstrap replicas in one pass over images. Throws
+   * std::invalid_argument unless every image is the size of the first.
+   *
+   * @param images The training images
+   * @param labels The label of each training image
+   * @param num_replicas Number of models in the ensemble
+   * @param seed Seed for the Poisson weights, so training is reproducible
+   */
+  void TrainModels(const Images& images, const std::vector<size_t>& labels,
+                   size_t num_replicas, unsigned seed);
+
+  /**
+   * Scores every class of every replica against the image. The image's
+   * shaded pixels are decoded once and shared by all replicas. Throws
+   * std::invalid_argument unless the image is the size of the training
+   * images.
+   *
+   * @param image The image to classify
+   * @param votes Overwritten with the number of replicas voting for each
+   * class, in the order of GetClasses()
+   * @param scores Overwritten with each class's likelihood score summed over
+   * all replicas, in the same order
+   */
+  void CalculateVotes(const Image& image, std::vector<size_t>& votes,
+                      std::vector<double>& scores) const;
+
+  /**
+   * Classifies the image as the class with the most votes. Ties are broken by
+   * the summed likelihood score.
+   */
+  size_t ClassifyImage(const Image& image) const;
+
+  /**
+   * Classifies every image and compares it against the expected labels.
+   * @return a decimal representing the percent correctly classified.
+   */
+  double CalculateAccuracy(const Images& images_to_classify,
+                           const std::vector<size_t>& expected_classes) const;
+
+  const std::vector<size_t>& GetClasses() const;
+
+  size_t GetReplicaCount() const;
+
+ private:
+  size_t num_replicas_ = 0;
+  size_t image_size_ = 0;
+  std::vector<size_t> classes_;
+
+  // Flattened [replica][class]: log10 of the class probability plus the log10
+  // probability of every pixel being unshaded.
+  std::vector<double> base_scores_;
+
+  // Flattened [replica][class][pixel]: amount added to the base score when the
+  // pixel is shaded.
+  std::vector<double> deltas_;
+
+  // Smoothing value for naive bayes.
+  constexpr static const double kLaplaceSmoothingValue = 1;
+
+  /**
+   * Throws std::invalid_argument unless image is image_size pixels square.
+   */
+  static void CheckImageSize(const Image& image, size_t image_size);
+
+  /**
+   * Writes the index of every shaded pixel of image, which must be
+   * image_size_ pixels square, into shaded_pixels.
+   */
+  void DecodeShadedPixels(const Image& image,
+                          std::vector<size_t>& shaded_pixels) const;
+};
+
+}  // namespace naivebayes
@@ -1,5 +1,8 @@
 #pragma once
+#ifdef _MSC_VER
 #pragma warning(disable : 4503)
+#endif
+#include <core/count_snapshot.h>
 #include <core/images.h>
 
 #include <map>
@@ -42,10 +45,34 @@ class BasicTrainingModel {
 
   /**
    * Public helper function so that user can train the model_.
-   * Calls the calculate functions.
+   * Counts the training images in one pass, then calls the calculate
+   * functions.
    */
   void TrainModel();
 
+  /**
+   * Trains the model from counts gathered elsewhere, such as the merged
+   * snapshots of several training shards. Replaces the classes, class sizes
+   * and image size with those of the snapshot.
+   *
+   * @param counts The counts to calculate probabilities from
+   */
+  void TrainModel(const CountSnapshot& counts);
+
+  /**
+   * Counts the training images and labels held by the model.
+   * @return a snapshot that can be saved or merged with other shards.
+   */
+  CountSnapshot CountImages() const;
+
+  /**
+   * Counts every shifted copy of the training images, without building the
+   * copies, so augmented training uses no more memory than plain training.
+   * @param shifts The offsets each image is counted at
+   * @return a snapshot that can be saved or merged with other shards.
+   */
+  CountSnapshot CountImages(const std::vector<ImageShift>& shifts) const;
+
   double GetPixelProbability(const size_t class_number, const size_t shade,
                              const size_t row, const size_t col) const;
 
@@ -57,10 +84,24 @@ class BasicTrainingModel {
    */
   std::vector<double> GetProbabilities() const;
 
-  std::vector<size_t> GetLabels() const;
+  const std::vector<size_t>& GetLabels() const;
 
+  const Images& GetTrainingImages() const;
+
+  /**
+   * Copies the training images into the model. Prefer the rvalue overload
+   * when the caller no longer needs its Images object.
+   */
   void SetImages(const Images& data_to_add);
 
+  void SetImages(Images&& data_to_add);
+
+  /**
+   * Sets the Laplace smoothing value used by the next TrainModel call.
+   * @param smoothing A positive pseudo count added to every count
+   */
+  void SetSmoothing(double smoothing);
+
  private:
   std::vector<size_t> image_labels_;
   std::unordered_map<size_t, size_t> class_sizes_;
@@ -72,8 +113,9 @@ class BasicTrainingModel {
   std::unordered_map<size_t, std::vector<std::vector<double>>>
       pixel_probabilities_;
 
-  // Smoothing value for naive bayes.
+  // Default smoothing value for naive bayes.
   constexpr static const double kLaplaceSmoothingValue = 1;
+  double smoothing_ = kLaplaceSmoothingValue;
   static const size_t kShaded = 1;
 
   /**
@@ -83,8 +125,10 @@ class BasicTrainingModel {
    *
    * P(class = c) = (k + # of images belonging to class c) / (10k +
    * Total # of training images)
+   *
+   * @param image_count Total # of training images
    */
-  void CalculateClassProbability();
+  void CalculateClassProbability(const size_t image_count);
 
   /**
    * Uses the formula below to calculate the pixel probability for each pixel,
@@ -93,8 +137,10 @@ class BasicTrainingModel {
    *
    * P(Fi,j = f | class = c) = (k + # of images belonging to class c
    * where Fi,j = f) / (2k + Total # of images belonging to class c)
+   *
+   * @param counts The unshaded pixel counts of each class
    */
-  void CalculatePixelProbability();
+  void CalculatePixelProbability(const CountSnapshot& counts);
 
   /**
    * Helper function that counts the number of classes and the size of each class.
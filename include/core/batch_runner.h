@@ -0,0 +1,112 @@
+#pragma once
+#include <core/images.h>
+
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace naivebayes {
+
+/**
+ * One train and evaluate configuration of a batch.
+ */
+struct BatchJob {
+  std::string name;
+
+  // Laplace smoothing value the model is trained with.
+  double smoothing = 1;
+
+  // Images are pooled by this factor before training and classifying.
+  size_t downsample = 1;
+
+  // Window of pooled pixels used as features when classifying, from the
+  // first row/col up to but not including the end row/col.
+  size_t first_row = 0;
+  size_t end_row = std::numeric_limits<size_t>::max();
+  size_t first_col = 0;
+  size_t end_col = std::numeric_limits<size_t>::max();
+
+  // Fraction of the training images held out for evaluation, or 0 to
+  // evaluate on the test images.
+  double holdout = 0;
+};
+
+/**
+ * What one job measured. error is set instead when the job failed.
+ */
+struct BatchResult {
+  BatchJob job;
+  size_t training_count = 0;
+  size_t evaluation_count = 0;
+  double accuracy = 0;
+  double top_3_accuracy = 0;
+  double training_time = 0;
+  double evaluation_time = 0;
+  std::string error;
+};
+
+/**
+ * Runs many train and evaluate jobs against datasets that are parsed once
+ * and shared, read-only, by every job. Jobs count straight from the shared
+ * images, so none of them copies a dataset, and they are scheduled on a
+ * work-stealing pool.
+ */
+class BatchRunner {
+ public:
+  /**
+   * @param training_images Images every job trains on; must outlive the
+   * runner
+   * @param training_labels Label of each training image
+   * @param test_images Images jobs without a holdout are evaluated on
+   * @param test_labels Label of each test image
+   * @param threads Number of jobs run at the same time
+   */
+  BatchRunner(const Images& training_images,
+              const std::vector<size_t>& training_labels,
+              const Images& test_images, const std::vector<size_t>& test_labels,
+              size_t threads);
+
+  /**
+   * Reads one job per line: a name followed by space separated key=value
+   * options, which are smoothing, downsample, rows=first:end,
+   * cols=first:end and holdout. Everything after a # is a comment. A
+   * malformed option throws std::invalid_argument naming its line and
+   * option.
+   *
+   * @param is The manifest stream
+   * @return the jobs in manifest order.
+   */
+  static std::vector<BatchJob> ReadManifest(std::istream& is);
+
+  /**
+   * Runs every job. A job that fails has its error recorded in its result
+   * and does not stop the others.
+   *
+   * @return the results in the order of the jobs.
+   */
+  std::vector<BatchResult> Run(const std::vector<BatchJob>& jobs) const;
+
+  /**
+   * Trains and evaluates a single job on the calling thread. Throws
+   * std::invalid_argument when its options are out of range or the images it
+   * evaluates, once pooled, are not the size of the pooled training images.
+   */
+  BatchResult RunJob(const BatchJob& job) const;
+
+  /**
+   * Writes one line per result with the job's options and its measurements.
+   */
+  static void WriteReport(std::ostream& os,
+                          const std::vector<BatchResult>& results);
+
+ private:
+  const Images& training_images_;
+  const std::vector<size_t>& training_labels_;
+  const Images& test_images_;
+  const std::vector<size_t>& test_labels_;
+  size_t threads_;
+};
+
+}  // namespace naivebayes
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace naivebayes {
+
+/**
+ * A fixed capacity, lock-free queue that any number of threads may push to
+ * and pop from. Every slot carries a sequence number that tells producers
+ * and consumers whose turn it is, so no mutex is ever taken.
+ *
+ * @tparam T The element type, which must be default constructible and
+ * movable.
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+  /**
+   * @param capacity The maximum number of queued elements, rounded up to the
+   * next power of two.
+   */
+  explicit BoundedQueue(size_t capacity) {
+    size_t rounded_capacity = 1;
+    while (rounded_capacity < capacity) {
+      rounded_capacity <<= 1;
+    }
+
+    mask_ = rounded_capacity - 1;
+    cells_.reset(new Cell[rounded_capacity]);
+    for (size_t index = 0; index < rounded_capacity; index++) {
+      cells_[index].sequence.store(index, std::memory_order_relaxed);
+    }
+    enqueue_position_.store(0, std::memory_order_relaxed);
+    dequeue_position_.store(0, std::memory_order_relaxed);
+  }
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  /**
+   * Moves value into the queue if there is room.
+   * @return false if the queue was full.
+   */
+  bool TryPush(T&& value) {
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+
+    while (true) {
+      Cell& cell = cells_[position & mask_];
+      size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      intptr_t difference = (intptr_t) sequence - (intptr_t) position;
+
+      if (difference == 0) {
+        if (enqueue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          cell.value = std::move(value);
+          cell.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * Moves the oldest element into value if the queue is not empty.
+   * @return false if the queue was empty.
+   */
+  bool TryPop(T& value) {
+    size_t position = dequeue_position_.load(std::memory_order_relaxed);
+
+    while (true) {
+      Cell& cell = cells_[position & mask_];
+      size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      intptr_t difference = (intptr_t) sequence - (intptr_t) (position + 1);
+
+      if (difference == 0) {
+        if (dequeue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          value = std::move(cell.value);
+          cell.sequence.store(position + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = dequeue_position_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * Pushes value, yielding the thread while the queue is full.
+   */
+  void Push(T&& value) {
+    while (!TryPush(std::move(value))) {
+      std::this_thread::yield();
+    }
+  }
+
+  /**
+   * Pops into value, yielding the thread while the queue is empty.
+   */
+  void Pop(T& value) {
+    while (!TryPop(value)) {
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  // Keeps the producer and consumer positions on separate cache lines.
+  static const size_t kCacheLineSize = 64;
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+  alignas(kCacheLineSize) std::atomic<size_t> enqueue_position_;
+  alignas(kCacheLineSize) std::atomic<size_t> dequeue_position_;
+};
+
+}  // namespace naivebayes
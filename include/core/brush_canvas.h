@@ -0,0 +1,107 @@
+#pragma once
+#include <core/images.h>
+
+namespace naivebayes {
+
+/**
+ * The drawing state behind the sketchpad, kept free of any rendering so it
+ * can be tested and benchmarked headless.
+ *
+ * Each brush movement shades every pixel whose center lies within the brush
+ * radius of the segment from the previous brush location, so fast drags
+ * leave no gaps. Only pixels inside the segment's bounding box are visited.
+ * The canvas also tracks the rectangle of pixels changed since the last
+ * ClearDirtyRegion, so a renderer only has to update those.
+ */
+class BrushCanvas {
+ public:
+  /**
+   * An inclusive rectangle of pixels.
+   */
+  struct Region {
+    size_t min_row;
+    size_t min_col;
+    size_t max_row;
+    size_t max_col;
+  };
+
+  /**
+   * @param num_pixels_per_side the number of pixels in one row/column
+   * @param brush_radius the maximum distance, in pixels, from the brush that
+   * will be shaded
+   */
+  explicit BrushCanvas(size_t num_pixels_per_side, double brush_radius = 1.15);
+
+  /**
+   * Starts a new stroke and shades the pixels around its first point.
+   *
+   * @param x Brush location, in pixels from the left edge
+   * @param y Brush location, in pixels from the top edge
+   */
+  void StartStroke(double x, double y);
+
+  /**
+   * Moves the brush to a new point, shading everything along the way from
+   * the previous point. Starts a stroke when none is in progress.
+   *
+   * @param x Brush location, in pixels from the left edge
+   * @param y Brush location, in pixels from the top edge
+   */
+  void ContinueStroke(double x, double y);
+
+  /**
+   * Unshades every pixel and ends the current stroke.
+   */
+  void Clear();
+
+  /**
+   * @return whether any pixel changed since the last ClearDirtyRegion.
+   */
+  bool IsDirty() const;
+
+  /**
+   * @return the smallest rectangle holding every pixel changed since the
+   * last ClearDirtyRegion; only meaningful when IsDirty.
+   */
+  const Region& GetDirtyRegion() const;
+
+  void ClearDirtyRegion();
+
+  const Image& GetImage() const;
+
+  /**
+   * @return the number of pixels whose distance to the brush was checked,
+   * summed over every brush movement.
+   */
+  size_t GetVisitedPixelCount() const;
+
+ private:
+  size_t num_pixels_per_side_;
+  double brush_radius_;
+  Image image_;
+
+  bool is_stroking_ = false;
+  double last_x_ = 0;
+  double last_y_ = 0;
+
+  bool is_dirty_ = false;
+  Region dirty_region_ = {0, 0, 0, 0};
+  size_t visited_pixel_count_ = 0;
+
+  static const char kShaded = '#';
+  static const char kUnshaded = ' ';
+
+  /**
+   * Shades the pixels within the brush radius of the segment between two
+   * points, which may be the same point.
+   */
+  void ShadeSegment(double start_x, double start_y, double end_x,
+                    double end_y);
+
+  /**
+   * Grows the dirty region to hold the given pixel.
+   */
+  void MarkDirty(size_t row, size_t col);
+};
+
+}  // namespace naivebayes
@@ -0,0 +1,86 @@
+#pragma once
+#include <core/classifier.h>
+
+#include <vector>
+
+namespace naivebayes {
+
+/**
+ * Classifies images with a series of increasingly detailed models.
+ *
+ * Each image is first pooled down to the coarsest resolution and classified
+ * there. If the best class beats the runner up by at least that level's
+ * threshold, the image is resolved early; otherwise it moves on to the next
+ * level, ending with a full resolution Classifier that always answers.
+ */
+class CascadeClassifier {
+ public:
+  /**
+   * Trains one model per downsampling factor plus a full resolution model,
+   * counting every resolution in a single pass over the images.
+   *
+   * @param images The training images
+   * @param labels The label of each training image
+   * @param factors Downsampling factor of each early level, coarsest first
+   */
+  void TrainModels(const Images& images, const std::vector<size_t>& labels,
+                   const std::vector<size_t>& factors);
+
+  /**
+   * Picks each early level's threshold as the lowest top-2 margin at which
+   * the images it would resolve agree with the full resolution model at
+   * least target_agreement of the time.
+   *
+   * @param images Images to tune on
+   * @param target_agreement Required agreement, between 0 and 1
+   */
+  void TuneThresholds(const Images& images, const double target_agreement);
+
+  /**
+   * Classifies the image at the first level that is confident enough and
+   * records which level resolved it.
+   */
+  size_t ClassifyImage(const Image& image);
+
+  /**
+   * Classifies every image and compares it against the expected labels.
+   * @return a decimal representing the percent correctly classified.
+   */
+  double CalculateAccuracy(const Images& images_to_classify,
+                           const std::vector<size_t>& expected_classes);
+
+  /**
+   * @return the fraction of images classified since the last ResetStatistics
+   * that were resolved before the full resolution level.
+   */
+  double GetEarlyFraction() const;
+
+  void ResetStatistics();
+
+  const Classifier& GetFullClassifier() const;
+
+  const std::vector<double>& GetThresholds() const;
+
+ private:
+  struct Level {
+    size_t factor;
+    Classifier classifier;
+  };
+
+  std::vector<Level> levels_;
+  std::vector<double> thresholds_;
+  Classifier full_classifier_;
+  Image pooled_image_;
+
+  size_t early_count_ = 0;
+  size_t image_count_ = 0;
+
+  /**
+   * Scores the image against every class of the classifier.
+   * @return the best class, writing its lead over the runner up to margin.
+   */
+  static size_t ClassifyWithMargin(const Classifier& classifier,
+                                   const Image& image, double& margin);
+};
+
+}  // namespace naivebayes
@@ -0,0 +1,91 @@
+#pragma once
+#include <core/classifier.h>
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace naivebayes {
+
+/**
+ * A bounded, thread safe, least recently used cache of classifications that
+ * sits in front of a Classifier.
+ *
+ * Images are keyed by a hash of their bit-packed pixels combined with a
+ * model version tag, so changing the tag after swapping models makes every
+ * old entry unreachable; those entries then age out. Each entry also keeps
+ * the packed pixels, so a hash collision can never return another image's
+ * class. The cache is split into independently locked shards to keep
+ * threads from contending on a single mutex.
+ */
+class ClassificationCache {
+ public:
+  /**
+   * @param classifier The classifier to call on a miss; must outlive the
+   * cache
+   * @param capacity Maximum number of cached images across all shards
+   * @param shard_count Number of independently locked shards
+   */
+  ClassificationCache(const Classifier& classifier, size_t capacity,
+                      size_t shard_count = 16);
+
+  /**
+   * Returns the cached class of an identical image classified under the
+   * current model version, or classifies the image and caches the result.
+   * Images with more than 64 rows, or a row wider than 64 pixels, are
+   * always classified and never cached.
+   */
+  size_t ClassifyImage(const Image& image);
+
+  /**
+   * Sets the tag mixed into every key. Call it whenever the classifier's
+   * model changes.
+   */
+  void SetModelVersion(uint64_t model_version);
+
+  size_t GetHits() const;
+
+  size_t GetMisses() const;
+
+  /**
+   * @return the number of images currently cached.
+   */
+  size_t Size() const;
+
+  /**
+   * Hashes the packed rows of an image together with a model version.
+   */
+  static uint64_t HashImage(const uint64_t* packed_rows, size_t row_count,
+                            uint64_t model_version);
+
+ private:
+  struct Entry {
+    uint64_t key;
+    PackedImage image;
+    size_t predicted_class;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+
+    // Most recently used entry first.
+    std::list<Entry> entries;
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+  };
+
+  const Classifier& classifier_;
+  size_t shard_capacity_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+  std::atomic<uint64_t> model_version_;
+  std::atomic<size_t> hits_;
+  std::atomic<size_t> misses_;
+
+  // Widest image the fixed size packing buffer holds.
+  static const size_t kMaxImageSize = 64;
+};
+
+}  // namespace naivebayes
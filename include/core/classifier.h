@@ -15,7 +15,8 @@ class Classifier {
    * @param image The image to classify
    * @return The likelihood score that the imagge belongs to class_num
    */
-  double CalculateLikelihoodScore(const size_t class_num, const Image image);
+  double CalculateLikelihoodScore(const size_t class_num,
+                                  const Image& image) const;
 
   /**
    * Calculates the likelihood score of an image belonging to every class
@@ -25,9 +26,11 @@ class Classifier {
    * @param image The image to classify
    * @return The class with the highest likelihood score
    */
-  size_t ClassifyImage(const Image& image);
+  size_t ClassifyImage(const Image& image) const;
 
-  void SetModel(BasicTrainingModel model);
+  void SetModel(const BasicTrainingModel& model);
+
+  void SetModel(BasicTrainingModel&& model);
 
   /**
    * Reads in the expected classes of each image that is used for testing
@@ -44,7 +47,9 @@ class Classifier {
    * @param images_to_classify Images object that is a vector of images
    * @return a decimal representing the percent correctly classified.
    */
-  double CalculateAccuracy(const Images& images_to_classify);
+  double CalculateAccuracy(const Images& images_to_classify) const;
+
+  const std::vector<size_t>& GetExpectedClasses() const;
 
  private:
   static const size_t kShaded = 1;
@@ -0,0 +1,131 @@
+#pragma once
+#include <core/images.h>
+
+#include <istream>
+#include <map>
+#include <ostream>
+#include <vector>
+
+namespace naivebayes {
+
+/**
+ * An offset an image is moved by before it is counted: pixels move down by
+ * rows and right by cols, which may be negative, and pixels moved in from
+ * outside the image are unshaded.
+ */
+struct ImageShift {
+  int rows;
+  int cols;
+};
+
+/**
+ * The raw counts a BasicTrainingModel is trained from: the list of classes,
+ * how many images belong to each class and, for every class and pixel, how
+ * many of those images leave the pixel unshaded.
+ *
+ * Snapshots of different shards of the training data can be written to
+ * files, read back in any process and summed with Merge in any order, so
+ * training can be split across processes or machines.
+ */
+class CountSnapshot {
+ public:
+  /**
+   * Overloads the >> operator to read a snapshot written by operator<<.
+   * The read counts replace any counts already held.
+   */
+  friend std::istream& operator>>(std::istream& is, CountSnapshot& counts);
+
+  /**
+   * Overloads the << operator to write the image size, the classes, the class
+   * sizes and then every unshaded count, one value per line.
+   */
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const CountSnapshot& counts);
+
+  /**
+   * Adds a single labelled image to the counts.
+   */
+  void AddImage(const Image& image, size_t label);
+
+  /**
+   * Adds the images in [begin, end) with their labels to the counts.
+   *
+   * @param images The images to count
+   * @param labels The label of each image
+   * @param begin Index of the first image to count
+   * @param end One past the index of the last image to count
+   */
+  void AddImages(const Images& images, const std::vector<size_t>& labels,
+                 size_t begin, size_t end);
+
+  /**
+   * Adds one copy of the image per shift, each counted as a separate image
+   * of the label. The shifted copies are never built: the image is packed
+   * into one word per row once and every copy is counted straight from the
+   * shifted words, so images may be at most 64 pixels wide.
+   *
+   * @param image The image to count
+   * @param label The image's class
+   * @param shifts The offsets of the copies; {0, 0} counts the image itself.
+   * With no shifts nothing is added, not even the label as a class
+   */
+  void AddImage(const Image& image, size_t label,
+                const std::vector<ImageShift>& shifts);
+
+  /**
+   * Adds every shifted copy of the images in [begin, end) with their labels
+   * to the counts.
+   */
+  void AddImages(const Images& images, const std::vector<size_t>& labels,
+                 size_t begin, size_t end,
+                 const std::vector<ImageShift>& shifts);
+
+  /**
+   * @return every shift whose rows and cols are both within max_offset of
+   * zero, including no shift at all.
+   */
+  static std::vector<ImageShift> MakeShifts(size_t max_offset);
+
+  /**
+   * Adds every count of other into this snapshot.
+   */
+  void Merge(const CountSnapshot& other);
+
+  size_t GetImageSize() const;
+
+  size_t GetImageCount() const;
+
+  /**
+   * @return every class seen so far, in ascending order.
+   */
+  std::vector<size_t> GetClasses() const;
+
+  size_t GetClassSize(const size_t class_number) const;
+
+  size_t GetUnshadedCount(const size_t class_number, const size_t row,
+                          const size_t col) const;
+
+ private:
+  // Widest image whose rows fit in one word each.
+  static const size_t kMaxPackedSize = 64;
+
+  size_t image_size_ = 0;
+  size_t image_count_ = 0;
+  std::map<size_t, size_t> class_sizes_;
+
+  // Flattened [row][col] unshaded counts of each class.
+  std::map<size_t, std::vector<size_t>> unshaded_counts_;
+
+  /**
+   * @return the unshaded counts of the class, creating them if needed.
+   */
+  std::vector<size_t>& GetOrAddCounts(const size_t class_number);
+
+  /**
+   * Sets the image size from the first image and checks that every image,
+   * including the first, has that many rows of that many pixels.
+   */
+  void CheckImageSize(const Image& image);
+};
+
+}  // namespace naivebayes
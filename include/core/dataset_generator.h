@@ -0,0 +1,71 @@
+#pragma once
+#include <core/basic_training_model.h>
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace naivebayes {
+
+/**
+ * Generates synthetic labelled images by sampling from a trained model: a
+ * class is drawn from the class probabilities, then each pixel is shaded
+ * with that class's probability of the pixel being shaded.
+ *
+ * Images are produced in fixed size chunks whose random stream depends only
+ * on the seed and the chunk's index, so the output is identical for any
+ * number of threads.
+ */
+class DatasetGenerator {
+ public:
+  /**
+   * @param model The trained model to sample from
+   * @param seed Seed of every chunk's random stream
+   * @param threads Number of chunks generated at the same time
+   */
+  DatasetGenerator(const BasicTrainingModel& model, uint64_t seed,
+                   size_t threads);
+
+  /**
+   * Generates image_count images and their labels. At most one chunk per
+   * thread is held in memory at a time.
+   *
+   * @param image_count Number of images to generate
+   * @param format Layout of the image stream; packed output starts with the
+   * packed header
+   * @param images_os Stream the images are written to
+   * @param labels_os Stream the labels are written to, one per line
+   */
+  void Generate(size_t image_count, ImageFormat format,
+                std::ostream& images_os, std::ostream& labels_os) const;
+
+  /**
+   * Generates one chunk of images into the given buffers.
+   *
+   * @param chunk_index Index of the chunk, which selects its random stream
+   * @param count Number of images in the chunk
+   * @param format Layout of the images
+   * @param images Overwritten with the formatted images
+   * @param labels Overwritten with the formatted labels
+   */
+  void GenerateChunk(size_t chunk_index, size_t count, ImageFormat format,
+                     std::string& images, std::string& labels) const;
+
+  // Number of images sharing one random stream.
+  static const size_t kChunkSize = 4096;
+
+ private:
+  uint64_t seed_;
+  size_t threads_;
+  size_t image_size_;
+  std::vector<size_t> classes_;
+
+  // Running total of the class probabilities, normalized to end at 1.
+  std::vector<double> cumulative_class_probabilities_;
+
+  // Flattened [class][row][col] probability of each pixel being shaded.
+  std::vector<double> shaded_probabilities_;
+};
+
+}  // namespace naivebayes
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace naivebayes {
+
+/**
+ * Running statistics of a classifier on a labelled test set: a confusion
+ * matrix, top-k accuracy and a histogram of the margin between the best and
+ * second best likelihood scores.
+ *
+ * Only O(classes^2) counts are kept no matter how many images are added, and
+ * reports over different parts of a test set can be merged in any order, so
+ * each thread can fill its own report.
+ */
+class EvaluationReport {
+ public:
+  /**
+   * @param classes The classes scores are given for, in the order they are
+   * given
+   * @param top_k Largest k whose top-k accuracy is tracked
+   * @param margin_bins Number of margin histogram bins; the last one also
+   * counts every larger margin
+   * @param margin_bin_width Width of each margin bin, in log10 likelihood
+   */
+  EvaluationReport(const std::vector<size_t>& classes, size_t top_k = 3,
+                   size_t margin_bins = 10, double margin_bin_width = 5);
+
+  /**
+   * Overloads the << operator to write the accuracies, per class precision
+   * and recall, the confusion matrix and the margin histogram.
+   */
+  friend std::ostream& operator<<(std::ostream& os,
+                                  const EvaluationReport& report);
+
+  /**
+   * Adds one classified image. The predicted class is the first class with
+   * the highest score, the same one Classifier::ClassifyImage picks. An image
+   * whose label is not one of the classes counts as misclassified but is
+   * left out of the confusion matrix and the margin histogram.
+   *
+   * @param label The image's true class
+   * @param scores The likelihood score of every class, in class order
+   */
+  void AddScores(size_t label, const std::vector<double>& scores);
+
+  /**
+   * Adds every count of other into this report.
+   */
+  void Merge(const EvaluationReport& other);
+
+  size_t GetImageCount() const;
+
+  /**
+   * @return how many added images had a label that is not one of the
+   * classes.
+   */
+  size_t GetUnknownLabelCount() const;
+
+  /**
+   * @return the fraction of images whose true class scored highest.
+   */
+  double GetAccuracy() const;
+
+  /**
+   * @return the fraction of images whose true class was among the k highest
+   * scores, for k from 1 to top_k.
+   */
+  double GetTopKAccuracy(size_t k) const;
+
+  /**
+   * @return how many images of class actual were classified as predicted.
+   */
+  size_t GetConfusionCount(size_t actual, size_t predicted) const;
+
+  /**
+   * @return the fraction of images classified as class_num that belong to
+   * it, or 0 when none were.
+   */
+  double GetPrecision(size_t class_num) const;
+
+  /**
+   * @return the fraction of images of class_num classified as it, or 0 when
+   * there were none.
+   */
+  double GetRecall(size_t class_num) const;
+
+  const std::vector<size_t>& GetMarginHistogram() const;
+
+  const std::vector<size_t>& GetClasses() const;
+
+ private:
+  std::vector<size_t> classes_;
+  double margin_bin_width_;
+  size_t image_count_ = 0;
+  size_t unknown_label_count_ = 0;
+
+  // Flattened [actual][predicted] counts, indexed by position in classes_.
+  std::vector<size_t> confusion_;
+
+  // Number of images whose true class had each rank, for ranks below top_k.
+  std::vector<size_t> rank_counts_;
+
+  std::vector<size_t> margin_histogram_;
+
+  /**
+   * @return the position of class_num in classes_, or classes_.size() when
+   * it is not one of them.
+   */
+  size_t FindClassIndex(size_t class_num) const;
+
+  /**
+   * @return the position of class_num in classes_.
+   */
+  size_t GetClassIndex(size_t class_num) const;
+};
+
+}  // namespace naivebayes
@@ -1,9 +1,20 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
 #include <vector>
 
 namespace naivebayes {
 typedef std::vector<std::vector<char>> Image;
 
+// One word per row with bit col set when the pixel at col is shaded, for
+// images up to 64 pixels wide.
+typedef std::vector<uint64_t> PackedImage;
+
+// The on-disk layouts an image file may use.
+enum class ImageFormat { kAscii, kPacked };
+
 class Images {
  public:
   /**
@@ -15,7 +26,72 @@ class Images {
    */
   friend std::istream& operator>>(std::istream& is, Images& data);
 
-  std::vector<Image> GetImages() const;
+  /**
+   * Reads the next square ascii image from the stream, so callers can parse
+   * a file one image at a time instead of holding all of it in memory.
+   *
+   * @param is The stream to read from
+   * @param image Overwritten with the image that was read
+   * @return false if the stream ended before a complete image was read
+   */
+  static bool ReadImage(std::istream& is, Image& image);
+
+  /**
+   * Pools every factor x factor block of the image into one pixel, which is
+   * shaded if any pixel in the block is shaded. Blocks along the bottom and
+   * right edges may be smaller when factor does not divide the image size.
+   *
+   * @param image The image to downsample
+   * @param factor The side length of each pooled block
+   * @param pooled Overwritten with the downsampled image
+   */
+  static void Downsample(const Image& image, const size_t factor,
+                         Image& pooled);
+
+  /**
+   * Packs the shade of every pixel into one bit, with the pixel at col in
+   * bit col of its row's word. Writes into a buffer the caller owns, so hot
+   * paths can pack without allocating.
+   *
+   * @param image The image to pack; at most 64 pixels wide
+   * @param packed_rows Overwritten with one word per row of the image; must
+   * hold image.size() words
+   */
+  static void PackImage(const Image& image, uint64_t* packed_rows);
+
+  /**
+   * Writes the header of the packed image format: the four bytes "NBPK"
+   * followed by the image size as a little-endian 32 bit integer. Every
+   * image after the header is stored row by row, each row taking
+   * (image size + 7) / 8 bytes with the pixel at col in bit col % 8 of byte
+   * col / 8.
+   */
+  static void WritePackedHeader(std::ostream& os, const size_t image_size);
+
+  /**
+   * Reads the header written by WritePackedHeader.
+   * @return the size of every image in the stream.
+   */
+  static size_t ReadPackedHeader(std::istream& is);
+
+  static void WritePackedImage(std::ostream& os, const Image& image);
+
+  /**
+   * Reads the next packed image, using '#' for shaded pixels.
+   *
+   * @param is The stream to read from, positioned after the header
+   * @param image_size The size read from the header
+   * @param image Overwritten with the image that was read
+   * @return false if the stream ended before a complete image was read
+   */
+  static bool ReadPackedImage(std::istream& is, const size_t image_size,
+                              Image& image);
+
+  const std::vector<Image>& GetImages() const;
+
+  const Image& GetImage(const size_t image_index) const;
+
+  size_t Size() const;
 
   char GetPixel(const size_t image_index, const size_t row, const size_t col) const;
 
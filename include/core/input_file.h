@@ -0,0 +1,104 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+namespace naivebayes {
+
+// How the bytes of an input are compressed.
+enum class Compression { kNone, kGzip, kZstd };
+
+/**
+ * A read-only stream buffer that decompresses another stream on a
+ * background thread, so decompressing overlaps with whatever parses the
+ * output. Decompressed chunks are handed over through a bounded queue,
+ * which caps how far ahead of the parser the thread may get. Unlike the
+ * pipeline's lock-free queue, this one blocks, since either side may wait
+ * on the disk for a long time.
+ *
+ * gzip needs the library to be built with zlib (NAIVEBAYES_HAVE_ZLIB) and
+ * zstd with libzstd (NAIVEBAYES_HAVE_ZSTD). Reading compressed data that is
+ * corrupt, truncated or of an unsupported format throws
+ * std::invalid_argument from the reading call.
+ */
+class DecompressingStreambuf : public std::streambuf {
+ public:
+  /**
+   * @param source The compressed stream; must outlive the buffer
+   * @param compression Format of the compressed stream
+   * @param queue_capacity Maximum number of decompressed chunks waiting to be
+   * read
+   */
+  DecompressingStreambuf(std::istream& source, Compression compression,
+                         size_t queue_capacity = 4);
+
+  ~DecompressingStreambuf() override;
+
+  /**
+   * Identifies the format of a stream by its first bytes and puts the bytes
+   * back.
+   */
+  static Compression DetectCompression(std::istream& source);
+
+ protected:
+  int_type underflow() override;
+
+ private:
+  struct Chunk {
+    std::string data;
+    bool is_last = false;
+    std::string error;
+  };
+
+  size_t queue_capacity_;
+  std::deque<Chunk> chunks_;
+  std::mutex chunks_mutex_;
+  std::condition_variable chunk_pushed_;
+  std::condition_variable chunk_popped_;
+  bool is_stopping_ = false;
+
+  Chunk current_;
+  std::thread decompressor_;
+
+  /**
+   * Runs on the background thread until the source ends, fails or the
+   * buffer is destroyed.
+   */
+  void Decompress(std::istream& source, Compression compression);
+
+  /**
+   * Hands a decompressed chunk to the reader.
+   * @return false if the buffer is being destroyed and nothing more is
+   * wanted.
+   */
+  bool PushChunk(Chunk&& chunk);
+};
+
+/**
+ * An input file stream that transparently decompresses gzip and zstd
+ * files, recognised by their first bytes, so every existing parser can read
+ * compressed datasets and models. Plain files are read directly.
+ */
+class InputFile : public std::istream {
+ public:
+  explicit InputFile(const std::string& file_path);
+
+  /**
+   * @return the format the file was found to have.
+   */
+  Compression GetCompression() const;
+
+ private:
+  std::ifstream file_;
+  Compression compression_ = Compression::kNone;
+  std::unique_ptr<DecompressingStreambuf> decompressing_buffer_;
+};
+
+}  // namespace naivebayes
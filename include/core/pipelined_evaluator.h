@@ -0,0 +1,78 @@
+#pragma once
+#include <core/classifier.h>
+#include <core/evaluation_report.h>
+
+#include <istream>
+#include <vector>
+
+namespace naivebayes {
+
+/**
+ * Evaluates a classifier while the test images are still being parsed.
+ *
+ * One thread parses blocks of images and labels and a configurable number of
+ * threads classify those blocks, each adding its results to its own
+ * EvaluationReport. The stages are connected by a bounded lock-free queue, so
+ * at most queue_capacity blocks of images are held in memory at once, and
+ * the per thread reports are merged once the streams are exhausted.
+ */
+class PipelinedEvaluator {
+ public:
+  /**
+   * @param classifier The classifier to evaluate; must outlive the evaluator
+   * @param classifier_threads Number of threads classifying blocks
+   * @param block_size Number of images parsed into each block
+   * @param queue_capacity Maximum number of blocks waiting in each queue
+   */
+  PipelinedEvaluator(const Classifier& classifier, size_t classifier_threads,
+                     size_t block_size = 64, size_t queue_capacity = 16);
+
+  /**
+   * Streams images and labels through the pipeline. Images without a
+   * matching label are ignored. Throws std::invalid_argument when an image is
+   * not the size the model was trained on.
+   *
+   * @param images_stream Stream of ascii images
+   * @param labels_stream Stream of whitespace separated labels
+   * @return a decimal representing the percent correctly classified.
+   */
+  double CalculateAccuracy(std::istream& images_stream,
+                           std::istream& labels_stream);
+
+  /**
+   * Streams images and labels through the pipeline and collects the full
+   * report. Images without a matching label are ignored. Throws
+   * std::invalid_argument when an image is not the size the model was
+   * trained on.
+   *
+   * @param images_stream Stream of ascii images
+   * @param labels_stream Stream of whitespace separated labels
+   * @param top_k Largest k whose top-k accuracy is reported
+   * @param margin_bins Number of margin histogram bins
+   * @param margin_bin_width Width of each margin bin, in log10 likelihood
+   * @return the merged report of every classifying thread.
+   */
+  EvaluationReport Evaluate(std::istream& images_stream,
+                            std::istream& labels_stream, size_t top_k = 3,
+                            size_t margin_bins = 10,
+                            double margin_bin_width = 5);
+
+  /**
+   * @return the number of images classified by the last evaluation.
+   */
+  size_t GetImageCount() const;
+
+ private:
+  struct ImageBlock {
+    std::vector<Image> images;
+    std::vector<size_t> labels;
+  };
+
+  const Classifier& classifier_;
+  size_t classifier_threads_;
+  size_t block_size_;
+  size_t queue_capacity_;
+  size_t image_count_ = 0;
+};
+
+}  // namespace naivebayes
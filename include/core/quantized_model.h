@@ -0,0 +1,96 @@
+#pragma once
+#include <core/basic_training_model.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace naivebayes {
+
+/**
+ * An inference-only copy of a trained BasicTrainingModel that stores scaled
+ * integer log-likelihoods instead of double probabilities.
+ *
+ * Every class score is split into a base (the class prior plus the log
+ * probability of every pixel being unshaded) and a per-pixel delta that is
+ * added when the pixel is shaded. Scoring an image is then one integer add
+ * per pixel, done branch free so the compiler can vectorize the row loops.
+ */
+class QuantizedModel {
+ public:
+  /**
+   * Quantizes the log-probabilities of model into integers of the given
+   * width.
+   *
+   * @param model The trained model to quantize
+   * @param bits Width of each stored delta, either 8 or 16
+   * @param scale Multiplier applied to every log10 probability before
+   * rounding; must not exceed GetMaxScale(model, bits)
+   */
+  void Quantize(const BasicTrainingModel& model, size_t bits, double scale);
+
+  /**
+   * Quantizes model with the smallest scale that classifies every image in
+   * calibration_images the same way as the double precision Classifier. If no
+   * scale reaches full agreement, the scale with the most agreement is used.
+   *
+   * @param model The trained model to quantize
+   * @param calibration_images Images used to compare against the float path
+   * @param bits Width of each stored delta, either 8 or 16
+   * @return the chosen scale
+   */
+  double Calibrate(const BasicTrainingModel& model,
+                   const Images& calibration_images, size_t bits);
+
+  /**
+   * Calculates the largest scale at which every delta still fits into the
+   * given bit width.
+   */
+  static double GetMaxScale(const BasicTrainingModel& model, size_t bits);
+
+  /**
+   * Calculates the scaled integer likelihood score of an image belonging to
+   * the class at class_index within classes_.
+   */
+  int32_t CalculateLikelihoodScore(const size_t class_index,
+                                   const Image& image) const;
+
+  size_t ClassifyImage(const Image& image) const;
+
+  /**
+   * Classifies every image and compares it against the expected labels.
+   * @return a decimal representing the percent correctly classified.
+   */
+  double CalculateAccuracy(const Images& images_to_classify,
+                           const std::vector<size_t>& expected_classes) const;
+
+  /**
+   * @return the number of bytes used by the quantized scoring tables.
+   */
+  size_t GetFootprintBytes() const;
+
+  double GetScale() const;
+
+  size_t GetBits() const;
+
+ private:
+  size_t bits_ = 0;
+  size_t image_size_ = 0;
+  double scale_ = 0;
+  std::vector<size_t> classes_;
+
+  // One entry per class: scaled prior plus every pixel unshaded.
+  std::vector<int32_t> base_scores_;
+
+  // Flattened [class][row][col] deltas. Only the vector matching bits_ is
+  // populated.
+  std::vector<int16_t> deltas16_;
+  std::vector<int8_t> deltas8_;
+
+  static const size_t kShaded = 1;
+  static const size_t kUnshaded = 0;
+
+  template <typename Delta>
+  int32_t ScoreImage(const Delta* deltas, const Image& image) const;
+};
+
+}  // namespace naivebayes
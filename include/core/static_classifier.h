@@ -0,0 +1,34 @@
+#pragma once
+#include <core/images.h>
+
+namespace naivebayes {
+
+/**
+ * Classifies images with a model that was compiled into the binary.
+ *
+ * The tables come from static_model_tables.h, which the compile-model tool
+ * generates from a saved model at build time, so there is no model file to
+ * ship and nothing to parse at startup. Because the image dimension and
+ * class count are compile-time constants, every scoring loop has fixed
+ * bounds.
+ */
+class StaticClassifier {
+ public:
+  /**
+   * Calculates the likelihood score of an image belonging to the class at
+   * class_index of the compiled class list.
+   */
+  static double CalculateLikelihoodScore(const size_t class_index,
+                                         const Image& image);
+
+  /**
+   * @return the compiled class with the highest likelihood score.
+   */
+  static size_t ClassifyImage(const Image& image);
+
+  static size_t GetImageDimension();
+
+  static size_t GetNumClasses();
+};
+
+}  // namespace naivebayes
@@ -0,0 +1,106 @@
+#pragma once
+#include <core/classifier.h>
+
+#include <condition_variable>
+#include <istream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace naivebayes {
+
+/**
+ * Classifies an unbounded stream of images and writes one line per image,
+ * in input order, so the classifier can sit in the middle of a shell
+ * pipeline.
+ *
+ * Images are read in fixed size batches. While one batch is classified by
+ * the worker threads, the next batch is being read, and every batch's output
+ * is written with a single call instead of flushing per line. The workers are
+ * started once per stream and wait between batches.
+ */
+class StreamClassifier {
+ public:
+  /**
+   * @param classifier The classifier to use; must outlive this object
+   * @param threads Number of threads classifying each batch
+   * @param batch_size Maximum number of images held per batch
+   * @param write_scores Whether to follow each label with the likelihood
+   * score of every class
+   */
+  StreamClassifier(const Classifier& classifier, size_t threads,
+                   size_t batch_size, bool write_scores);
+
+  /**
+   * Classifies every image in the input stream. Each output line is the
+   * predicted label, followed when scores are enabled by a tab and the
+   * space separated score of each class in model order. Throws
+   * std::invalid_argument when an image, or the size in a packed header, is
+   * not the size the model was trained on; labels of earlier batches may
+   * already have been written.
+   *
+   * @param is The image stream
+   * @param format The layout of the image stream
+   * @param os The stream to write labels to
+   * @return the number of images classified.
+   */
+  size_t ClassifyStream(std::istream& is, ImageFormat format,
+                        std::ostream& os) const;
+
+ private:
+  const Classifier& classifier_;
+  size_t threads_;
+  size_t batch_size_;
+  bool write_scores_;
+
+  /**
+   * Reads up to batch_size_ images into batch, checking that each is
+   * image_size pixels square.
+   * @return the number of images read.
+   */
+  size_t ReadBatch(std::istream& is, ImageFormat format, size_t image_size,
+                   std::vector<Image>& batch) const;
+
+  /**
+   * State shared by a stream and its worker threads. Each batch gets a new
+   * generation number, and every worker formats its own contiguous slice of
+   * the batch, so joining the slices in thread order keeps the input order.
+   */
+  struct Workers {
+    std::mutex mutex;
+    std::condition_variable batch_ready;
+    std::condition_variable batch_done;
+    const std::vector<Image>* batch = nullptr;
+    size_t count = 0;
+    size_t generation = 0;
+    size_t busy_count = 0;
+    bool is_stopping = false;
+    std::vector<std::string> slices;
+  };
+
+  /**
+   * Formats a slice of every batch until the workers are stopped.
+   */
+  void RunWorker(Workers& workers, size_t thread) const;
+
+  /**
+   * Hands the first count images of batch to the workers, which read it until
+   * FinishBatch returns.
+   */
+  void StartBatch(Workers& workers, const std::vector<Image>& batch,
+                  size_t count) const;
+
+  /**
+   * Waits for the workers to finish the batch given to StartBatch.
+   * @return the output lines of the batch, in order.
+   */
+  std::string FinishBatch(Workers& workers) const;
+
+  /**
+   * Appends the output line of one image to output.
+   */
+  void WriteLine(const Image& image, std::string& output) const;
+};
+
+}  // namespace naivebayes
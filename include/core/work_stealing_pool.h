@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace naivebayes {
+
+/**
+ * Runs a batch of independent tasks on a fixed number of threads. Every
+ * thread starts with its own deque of tasks, works from the back of it and,
+ * once it runs dry, steals from the front of another thread's deque, so
+ * threads that draw short tasks help with the long ones instead of idling.
+ */
+class WorkStealingPool {
+ public:
+  /**
+   * @param threads Number of threads running tasks
+   */
+  explicit WorkStealingPool(size_t threads);
+
+  /**
+   * Calls task once with every index in [0, task_count) and returns when all
+   * calls have finished. Tasks must not throw.
+   *
+   * @param task_count Number of tasks
+   * @param task Called with the index of each task
+   */
+  void Run(size_t task_count, const std::function<void(size_t)>& task);
+
+  /**
+   * @return the number of tasks the last Run took from another thread's
+   * deque.
+   */
+  size_t GetStolenCount() const;
+
+ private:
+  struct TaskDeque {
+    std::mutex mutex;
+    std::deque<size_t> tasks;
+  };
+
+  size_t threads_;
+  size_t stolen_count_ = 0;
+
+  /**
+   * Takes the next task for a thread, stealing when its own deque is empty.
+   * @return false once every deque is empty.
+   */
+  bool TakeTask(std::vector<std::unique_ptr<TaskDeque>>& deques,
+                size_t thread, size_t& task, bool& is_stolen);
+};
+
+}  // namespace naivebayes
@@ -6,6 +6,10 @@
 #include "sketchpad.h"
 #include <core/classifier.h>
 
+#ifdef NAIVEBAYES_STATIC_MODEL
+#include <core/static_classifier.h>
+#endif
+
 namespace naivebayes {
 
 namespace visualizer {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <core/brush_canvas.h>
+
 #include "cinder/gl/gl.h"
 
 namespace naivebayes {
@@ -10,6 +12,11 @@ namespace visualizer {
  * A sketchpad which will be displayed in the Cinder application and respond to
  * mouse events. Furthermore, the sketchpad can output its current state in the
  * same format as the Naive Bayes image data files.
+ *
+ * The drawing itself is kept in a BrushCanvas. Every sketchpad pixel is one
+ * quad of a single mesh, so a frame takes two draw calls no matter how many
+ * pixels there are, and only the colors of pixels the brush changed are
+ * uploaded again.
  */
 class Sketchpad {
  public:
@@ -31,13 +38,25 @@ class Sketchpad {
 
   /**
    * Displays the current state of the sketchpad in the Cinder application.
+   * The meshes are built on the first call, when a GL context is sure to
+   * exist.
+   */
+  void Draw();
+
+  /**
+   * Starts a new stroke, shading the sketchpad pixels whose centers are
+   * within brush_radius units of the brush's location. (One unit is equal to
+   * the length of one sketchpad pixel.)
+   *
+   * @param brush_screen_coords the screen coordinates at which the brush is
+   *           located
    */
-  void Draw() const;
+  void StartStroke(const glm::vec2& brush_screen_coords);
 
   /**
    * Shades in the sketchpad pixels whose centers are within brush_radius units
-   * of the brush's location. (One unit is equal to the length of one sketchpad
-   * pixel.)
+   * of the line from the brush's previous location to its new one, so fast
+   * drags leave no gaps.
    *
    * @param brush_screen_coords the screen coordinates at which the brush is
    *           located
@@ -49,7 +68,7 @@ class Sketchpad {
    */
   void Clear();
 
-  std::vector<std::vector<char>> GetDrawingImage();
+  const std::vector<std::vector<char>>& GetDrawingImage() const;
 
  private:
   glm::vec2 top_left_corner_;
@@ -59,13 +78,28 @@ class Sketchpad {
   /** Number of screen pixels in the width/height of one sketchpad pixel */
   double pixel_side_length_;
 
-  double brush_radius_;
+  BrushCanvas canvas_;
 
-  std::vector<std::vector<char>> sketchpad_image_;
+  /** One quad of four vertices per sketchpad pixel, in row major order */
+  ci::gl::VboMeshRef pixels_mesh_;
+  ci::gl::BatchRef pixels_batch_;
+  ci::gl::BatchRef grid_batch_;
 
-  const char kShaded = '#';
-  const char kUnshaded = ' ';
+  /**
+   * Builds the pixel mesh and the grid lines drawn between pixels.
+   */
+  void BuildMeshes();
 
+  /**
+   * Uploads the colors of the pixels the canvas changed since the last
+   * upload.
+   */
+  void UpdateDirtyPixels();
+
+  /**
+   * @return the color the pixel at row and col is drawn with.
+   */
+  ci::Color GetPixelColor(size_t row, size_t col) const;
 };
 
 }  // namespace visualizer
@@ -0,0 +1,67 @@
+// Replaces the global operator new and operator delete so that every heap
+// allocation is reported to the AllocationTracker. Only link this into
+// programs that want allocation counts; the array and sized forms of the
+// operators forward to these by default.
+#include <core/allocation_tracker.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Every block starts with a header holding its size, so deletes can report
+// how many bytes they free. The header keeps the block maximally aligned.
+union BlockHeader {
+  size_t size;
+  std::max_align_t alignment;
+};
+
+void* Allocate(std::size_t size) noexcept {
+  void* block = std::malloc(sizeof(BlockHeader) + size);
+  if (block == nullptr) {
+    return nullptr;
+  }
+
+  static_cast<BlockHeader*>(block)->size = size;
+  naivebayes::AllocationTracker::RecordAllocation(size);
+  return static_cast<BlockHeader*>(block) + 1;
+}
+
+void Deallocate(void* pointer) noexcept {
+  if (pointer == nullptr) {
+    return;
+  }
+
+  BlockHeader* header = static_cast<BlockHeader*>(pointer) - 1;
+  naivebayes::AllocationTracker::RecordDeallocation(header->size);
+  std::free(header);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  for (;;) {
+    if (void* pointer = Allocate(size)) {
+      return pointer;
+    }
+
+    std::new_handler handler = std::get_new_handler();
+    if (handler == nullptr) {
+      throw std::bad_alloc();
+    }
+    handler();
+  }
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+  return Allocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+  Deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+  Deallocate(pointer);
+}
@@ -0,0 +1,146 @@
+#include <core/allocation_tracker.h>
+
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#ifdef _MSC_VER
+#pragma comment(lib, "psapi.lib")
+#endif
+#else
+#include <sys/resource.h>
+#endif
+
+namespace naivebayes {
+
+namespace {
+
+std::atomic<size_t> allocations(0);
+std::atomic<size_t> allocated_bytes(0);
+std::atomic<size_t> freed_bytes(0);
+std::atomic<size_t> live_bytes(0);
+std::atomic<size_t> peak_live_bytes(0);
+
+std::mutex stages_mutex;
+std::vector<AllocationTracker::StageStats> closed_stages;
+
+}  // namespace
+
+AllocationTracker::Stage::Stage(const std::string& name)
+    : name_(name),
+      start_allocations_(allocations.load()),
+      start_allocated_bytes_(allocated_bytes.load()),
+      start_freed_bytes_(freed_bytes.load()),
+      start_live_bytes_(live_bytes.load()) {
+  // Measures this stage's peak from what is live now, and puts the enclosing
+  // stage's peak back when this one closes.
+  outer_peak_live_bytes_ = peak_live_bytes.exchange(start_live_bytes_);
+}
+
+AllocationTracker::Stage::~Stage() {
+  StageStats stats;
+  stats.name = name_;
+  stats.allocations = allocations.load() - start_allocations_;
+  stats.allocated_bytes = allocated_bytes.load() - start_allocated_bytes_;
+  stats.freed_bytes = freed_bytes.load() - start_freed_bytes_;
+
+  size_t peak = peak_live_bytes.load();
+  stats.peak_live_bytes = peak > start_live_bytes_ ? peak - start_live_bytes_
+                                                   : 0;
+  if (outer_peak_live_bytes_ > peak) {
+    peak_live_bytes.store(outer_peak_live_bytes_);
+  }
+  stats.peak_resident_bytes = GetPeakResidentBytes();
+
+  std::lock_guard<std::mutex> lock(stages_mutex);
+  closed_stages.push_back(stats);
+}
+
+void AllocationTracker::RecordAllocation(size_t bytes) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  size_t live = live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+
+  size_t peak = peak_live_bytes.load(std::memory_order_relaxed);
+  while (peak < live && !peak_live_bytes.compare_exchange_weak(
+                            peak, live, std::memory_order_relaxed)) {
+  }
+}
+
+void AllocationTracker::RecordDeallocation(size_t bytes) {
+  freed_bytes.fetch_add(bytes, std::memory_order_relaxed);
+  live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool AllocationTracker::IsCounting() {
+  return allocations.load() > 0;
+}
+
+std::vector<AllocationTracker::StageStats> AllocationTracker::GetStages() {
+  std::lock_guard<std::mutex> lock(stages_mutex);
+  return closed_stages;
+}
+
+void AllocationTracker::ClearStages() {
+  std::lock_guard<std::mutex> lock(stages_mutex);
+  closed_stages.clear();
+}
+
+size_t AllocationTracker::GetPeakResidentBytes() {
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+    return counters.PeakWorkingSetSize;
+  }
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#ifdef __APPLE__
+  // macOS reports bytes, Linux reports kilobytes.
+  return usage.ru_maxrss;
+#else
+  return (size_t) usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+void AllocationTracker::WriteReport(std::ostream& os) {
+  const double kMegabyte = 1024 * 1024;
+  std::vector<StageStats> stages = GetStages();
+  bool is_counting = IsCounting();
+
+  os << std::left << std::setw(12) << "stage" << std::right;
+  if (is_counting) {
+    os << std::setw(14) << "allocations" << std::setw(14) << "allocated MB"
+       << std::setw(12) << "freed MB" << std::setw(16) << "peak live MB";
+  }
+  os << std::setw(16) << "peak RSS MB" << std::endl;
+
+  os << std::fixed << std::setprecision(2);
+  for (const StageStats& stats : stages) {
+    os << std::left << std::setw(12) << stats.name << std::right;
+    if (is_counting) {
+      os << std::setw(14) << stats.allocations << std::setw(14)
+         << stats.allocated_bytes / kMegabyte << std::setw(12)
+         << stats.freed_bytes / kMegabyte << std::setw(16)
+         << stats.peak_live_bytes / kMegabyte;
+    }
+    os << std::setw(16) << stats.peak_resident_bytes / kMegabyte << std::endl;
+  }
+  os.unsetf(std::ios::fixed);
+  os << std::setprecision(6);
+
+  if (!is_counting) {
+    os << "Allocation counts need the allocation hooks; configure with "
+          "-DNAIVEBAYES_TRACK_ALLOCATIONS=ON."
+       << std::endl;
+  }
+}
+
+}  // namespace naivebayes
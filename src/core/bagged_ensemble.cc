@@ -0,0 +1,206 @@
+#include <core/bagged_ensemble.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+namespace naivebayes {
+
+void BaggedEnsemble::TrainModels(const Images& images,
+                                 const std::vector<size_t>& labels,
+                                 size_t num_replicas, unsigned seed) {
+  if (num_replicas == 0 || images.Size() == 0 ||
+      labels.size() != images.Size()) {
+    throw std::invalid_argument("Every training image needs one label");
+  }
+
+  // Checked before any state changes, so a failed call leaves the ensemble
+  // as it was.
+  size_t image_size = images.GetImage(0).size();
+  for (size_t index = 0; index < images.Size(); index++) {
+    CheckImageSize(images.GetImage(index), image_size);
+  }
+
+  num_replicas_ = num_replicas;
+  image_size_ = image_size;
+  classes_ = labels;
+  std::sort(classes_.begin(), classes_.end());
+  classes_.erase(std::unique(classes_.begin(), classes_.end()),
+                 classes_.end());
+
+  size_t num_classes = classes_.size();
+  size_t pixel_count = image_size_ * image_size_;
+
+  // Weighted counts: total weight per replica, weight per replica and class,
+  // and weight of shaded images per replica, class and pixel.
+  std::vector<size_t> replica_weights(num_replicas_, 0);
+  std::vector<size_t> class_weights(num_replicas_ * num_classes, 0);
+  std::vector<size_t> shaded_counts(num_replicas_ * num_classes * pixel_count,
+                                    0);
+
+  // Seeding each replica with seed + replica would give seeds s and s + 1
+  // overlapping replicas, so both are mixed through a seed sequence.
+  std::vector<std::mt19937> generators;
+  for (size_t replica = 0; replica < num_replicas_; replica++) {
+    std::seed_seq replica_seed{seed, (unsigned) replica};
+    generators.emplace_back(replica_seed);
+  }
+  std::poisson_distribution<size_t> bootstrap_weight(1.0);
+
+  std::vector<size_t> shaded_pixels;
+  for (size_t index = 0; index < images.Size(); index++) {
+    size_t class_index =
+        std::lower_bound(classes_.begin(), classes_.end(), labels[index]) -
+        classes_.begin();
+    DecodeShadedPixels(images.GetImage(index), shaded_pixels);
+
+    for (size_t replica = 0; replica < num_replicas_; replica++) {
+      size_t weight = bootstrap_weight(generators[replica]);
+      if (weight == 0) {
+        continue;
+      }
+
+      size_t model_index = replica * num_classes + class_index;
+      replica_weights[replica] += weight;
+      class_weights[model_index] += weight;
+
+      size_t* counts = &shaded_counts[model_index * pixel_count];
+      for (size_t pixel : shaded_pixels) {
+        counts[pixel] += weight;
+      }
+    }
+  }
+
+  // Converts the counts into log probabilities with the same smoothing as
+  // BasicTrainingModel.
+  base_scores_.assign(num_replicas_ * num_classes, 0);
+  deltas_.assign(num_replicas_ * num_classes * pixel_count, 0);
+
+  for (size_t replica = 0; replica < num_replicas_; replica++) {
+    for (size_t class_index = 0; class_index < num_classes; class_index++) {
+      size_t model_index = replica * num_classes + class_index;
+      double class_weight = class_weights[model_index];
+
+      double base = log10(
+          (kLaplaceSmoothingValue + class_weight) /
+          (kLaplaceSmoothingValue * num_classes + replica_weights[replica]));
+
+      for (size_t pixel = 0; pixel < pixel_count; pixel++) {
+        double shaded = shaded_counts[model_index * pixel_count + pixel];
+        double denominator = kLaplaceSmoothingValue * 2 + class_weight;
+        double unshaded_probability =
+            (kLaplaceSmoothingValue + class_weight - shaded) / denominator;
+        double shaded_probability =
+            (kLaplaceSmoothingValue + shaded) / denominator;
+
+        base += log10(unshaded_probability);
+        deltas_[model_index * pixel_count + pixel] =
+            log10(shaded_probability) - log10(unshaded_probability);
+      }
+      base_scores_[model_index] = base;
+    }
+  }
+}
+
+void BaggedEnsemble::CheckImageSize(const Image& image, size_t image_size) {
+  if (image.size() != image_size) {
+    throw std::invalid_argument("Image is not the size of the training images");
+  }
+  for (const std::vector<char>& row : image) {
+    if (row.size() != image_size) {
+      throw std::invalid_argument(
+          "Image is not the size of the training images");
+    }
+  }
+}
+
+void BaggedEnsemble::DecodeShadedPixels(
+    const Image& image, std::vector<size_t>& shaded_pixels) const {
+  shaded_pixels.clear();
+  for (size_t row = 0; row < image_size_; row++) {
+    for (size_t col = 0; col < image_size_; col++) {
+      if (image[row][col] != ' ') {
+        shaded_pixels.push_back(row * image_size_ + col);
+      }
+    }
+  }
+}
+
+void BaggedEnsemble::CalculateVotes(const Image& image,
+                                    std::vector<size_t>& votes,
+                                    std::vector<double>& scores) const {
+  size_t num_classes = classes_.size();
+  size_t pixel_count = image_size_ * image_size_;
+  votes.assign(num_classes, 0);
+  scores.assign(num_classes, 0);
+
+  CheckImageSize(image, image_size_);
+  std::vector<size_t> shaded_pixels;
+  DecodeShadedPixels(image, shaded_pixels);
+
+  // One fused loop over every replica and class, reusing the decoded pixels.
+  for (size_t replica = 0; replica < num_replicas_; replica++) {
+    size_t best_class = 0;
+    double best_score = -DBL_MAX;
+
+    for (size_t class_index = 0; class_index < num_classes; class_index++) {
+      size_t model_index = replica * num_classes + class_index;
+      const double* deltas = &deltas_[model_index * pixel_count];
+      double score = base_scores_[model_index];
+
+      for (size_t pixel : shaded_pixels) {
+        score += deltas[pixel];
+      }
+
+      scores[class_index] += score;
+      if (best_score < score) {
+        best_score = score;
+        best_class = class_index;
+      }
+    }
+    votes[best_class]++;
+  }
+}
+
+size_t BaggedEnsemble::ClassifyImage(const Image& image) const {
+  std::vector<size_t> votes;
+  std::vector<double> scores;
+  CalculateVotes(image, votes, scores);
+
+  size_t best_index = 0;
+  for (size_t index = 1; index < votes.size(); index++) {
+    if (votes[index] > votes[best_index] ||
+        (votes[index] == votes[best_index] &&
+         scores[index] > scores[best_index])) {
+      best_index = index;
+    }
+  }
+  return classes_[best_index];
+}
+
+double BaggedEnsemble::CalculateAccuracy(
+    const Images& images_to_classify,
+    const std::vector<size_t>& expected_classes) const {
+  size_t correct_count = 0;
+
+  for (size_t index = 0; index < expected_classes.size(); index++) {
+    if (ClassifyImage(images_to_classify.GetImage(index)) ==
+        expected_classes[index]) {
+      correct_count++;
+    }
+  }
+
+  return ((double) correct_count) / (expected_classes.size());
+}
+
+const std::vector<size_t>& BaggedEnsemble::GetClasses() const {
+  return classes_;
+}
+
+size_t BaggedEnsemble::GetReplicaCount() const {
+  return num_replicas_;
+}
+
+}  // namespace naivebayes
@@ -1,13 +1,20 @@
 #include <core/basic_training_model.h>
+#include <core/input_file.h>
 #include <algorithm>
-#include <fstream>
 #include <iostream>
+#include <stdexcept>
+#include <utility>
 
 namespace naivebayes {
 
 void BasicTrainingModel::SetImages(const Images& data_to_add) {
   training_images_ = data_to_add;
-  image_size_ = training_images_.GetImages()[0].size();
+  image_size_ = training_images_.GetImage(0).size();
+}
+
+void BasicTrainingModel::SetImages(Images&& data_to_add) {
+  training_images_ = std::move(data_to_add);
+  image_size_ = training_images_.GetImage(0).size();
 }
 
 std::istream& operator>>(std::istream& is, BasicTrainingModel& model) {
@@ -18,6 +25,7 @@ std::istream& operator>>(std::istream& is, BasicTrainingModel& model) {
   is >> model.image_size_;
   is >> model.num_classes_;
 
+  model.classes_.clear();
   for (size_t index = 0; index < model.num_classes_; index++) {
     size_t class_value;
     is >> class_value;
@@ -54,10 +62,9 @@ std::ostream& operator<<(std::ostream& os, const BasicTrainingModel& model) {
     os << class_number << std::endl;
   }
 
-  // Then writes class probabilities.
-  for (std::pair<const size_t, double> probability :
-       model.class_probabilities_) {
-    os << probability.second << std::endl;
+  // Then writes class probabilities in the same order operator>> reads them.
+  for (size_t class_number: model.classes_) {
+    os << model.class_probabilities_.at(class_number) << std::endl;
   }
 
   // Nested for loops iterate through every possible probability stored.
@@ -74,7 +81,7 @@ std::ostream& operator<<(std::ostream& os, const BasicTrainingModel& model) {
 
 void BasicTrainingModel::ReadLabels(const std::string& file_path) {
   size_t label;
-  std::ifstream is(file_path);
+  InputFile is(file_path);
 
   if (is.fail()) {
     throw std::invalid_argument("File does not exist or is blank");
@@ -110,41 +117,62 @@ void BasicTrainingModel::CountSizeNumClasses() {
 }
 
 void BasicTrainingModel::TrainModel() {
-  CalculateClassProbability();
-  CalculatePixelProbability();
+  TrainModel(CountImages());
 }
 
-void BasicTrainingModel::CalculateClassProbability() {
+void BasicTrainingModel::TrainModel(const CountSnapshot& counts) {
+  image_size_ = counts.GetImageSize();
+  classes_ = counts.GetClasses();
+  num_classes_ = classes_.size();
+
+  class_sizes_.clear();
+  class_probabilities_.clear();
+  pixel_probabilities_.clear();
+  for (size_t class_number: classes_) {
+    class_sizes_[class_number] = counts.GetClassSize(class_number);
+  }
+
+  CalculateClassProbability(counts.GetImageCount());
+  CalculatePixelProbability(counts);
+}
+
+CountSnapshot BasicTrainingModel::CountImages() const {
+  CountSnapshot counts;
+  counts.AddImages(training_images_, image_labels_, 0, image_labels_.size());
+  return counts;
+}
+
+CountSnapshot BasicTrainingModel::CountImages(
+    const std::vector<ImageShift>& shifts) const {
+  CountSnapshot counts;
+  counts.AddImages(training_images_, image_labels_, 0, image_labels_.size(),
+                   shifts);
+  return counts;
+}
+
+void BasicTrainingModel::CalculateClassProbability(const size_t image_count) {
   for (size_t class_number: classes_) {
 
     double class_probability =
-        (kLaplaceSmoothingValue + class_sizes_[class_number]) /
-        (kLaplaceSmoothingValue * num_classes_ + image_labels_.size());
+        (smoothing_ + class_sizes_[class_number]) /
+        (smoothing_ * num_classes_ + image_count);
     class_probabilities_[class_number] = class_probability;
   }
 }
 
-void BasicTrainingModel::CalculatePixelProbability() {
+void BasicTrainingModel::CalculatePixelProbability(
+    const CountSnapshot& counts) {
   // Iterates through every possiblity.
   for (size_t class_number: classes_) {
-    size_t image_count = 0;
     std::vector<std::vector<double>> temp;
     for (size_t row = 0; row < image_size_; row++) {
       std::vector<double> probabilities;
       for (size_t col = 0; col < image_size_; col++) {
-        for (size_t index = 0; index < image_labels_.size(); index++) {
-          // Iterates through image_classes and only continues if the class is the
-          // given one.
-          if (image_labels_[index] == class_number &&
-              training_images_.GetPixel(index, row, col) == ' ') {
-            // Number of images_ satisfying F(i,j) = ''.
-            image_count++;
-          }
-        }
-        double pixel_probability = (kLaplaceSmoothingValue + image_count) /
-                                   (kLaplaceSmoothingValue * 2 + class_sizes_[class_number]);
+        // Number of images_ satisfying F(i,j) = ''.
+        size_t image_count = counts.GetUnshadedCount(class_number, row, col);
+        double pixel_probability = (smoothing_ + image_count) /
+                                   (smoothing_ * 2 + class_sizes_[class_number]);
         probabilities.push_back(pixel_probability);
-        image_count = 0;
       }
       temp.push_back(probabilities);
     }
@@ -152,6 +180,13 @@ void BasicTrainingModel::CalculatePixelProbability() {
   }
 }
 
+void BasicTrainingModel::SetSmoothing(double smoothing) {
+  if (!(smoothing > 0)) {
+    throw std::invalid_argument("Smoothing must be positive");
+  }
+  smoothing_ = smoothing;
+}
+
 double BasicTrainingModel::GetClassProbability(
     const size_t class_number) const {
   return class_probabilities_.at(class_number);
@@ -171,8 +206,8 @@ double BasicTrainingModel::GetPixelProbability(const size_t class_number,
 std::vector<double> BasicTrainingModel::GetProbabilities() const {
   std::vector<double> temp;
 
-  for (std::pair<size_t, double> probability : class_probabilities_) {
-    temp.push_back(probability.second);
+  for (size_t class_num: classes_) {
+    temp.push_back(class_probabilities_.at(class_num));
   }
 
   for (size_t class_num: classes_) {
@@ -186,8 +221,12 @@ std::vector<double> BasicTrainingModel::GetProbabilities() const {
   return temp;
 }
 
-std::vector<size_t> BasicTrainingModel::GetLabels() const {
+const std::vector<size_t>& BasicTrainingModel::GetLabels() const {
   return image_labels_;
 }
 
+const Images& BasicTrainingModel::GetTrainingImages() const {
+  return training_images_;
+}
+
 }  // namespace naivebayes
\ No newline at end of file
@@ -0,0 +1,319 @@
+#include <core/basic_training_model.h>
+#include <core/batch_runner.h>
+#include <core/count_snapshot.h>
+#include <core/evaluation_report.h>
+#include <core/work_stealing_pool.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+namespace naivebayes {
+
+namespace {
+
+/**
+ * @return the wall time in milliseconds since start.
+ */
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+/**
+ * Parses a whole option value as a count; std::stoul would accept a sign,
+ * wrapping "-1" around to SIZE_MAX, and ignore trailing characters.
+ */
+size_t ParseCount(const std::string& value) {
+  size_t end = 0;
+  if (value.empty() || !std::isdigit((unsigned char) value[0])) {
+    throw std::invalid_argument("expected a non-negative whole number");
+  }
+  size_t count = std::stoul(value, &end);
+  if (end != value.size()) {
+    throw std::invalid_argument("expected a non-negative whole number");
+  }
+  return count;
+}
+
+/**
+ * Parses a whole option value as a number.
+ */
+double ParseNumber(const std::string& value) {
+  size_t end = 0;
+  if (value.empty()) {
+    throw std::invalid_argument("expected a number");
+  }
+  double number = std::stod(value, &end);
+  if (end != value.size()) {
+    throw std::invalid_argument("expected a number");
+  }
+  return number;
+}
+
+/**
+ * Parses a first:end range option.
+ */
+void ParseRange(const std::string& value, size_t& first, size_t& end) {
+  size_t colon = value.find(':');
+  if (colon == std::string::npos) {
+    throw std::invalid_argument("ranges are written first:end");
+  }
+  first = ParseCount(value.substr(0, colon));
+  end = ParseCount(value.substr(colon + 1));
+}
+
+/**
+ * @return the image pooled by factor, or the image itself when factor is 1.
+ */
+const Image& PoolImage(const Image& image, size_t factor, Image& pooled) {
+  if (factor == 1) {
+    return image;
+  }
+  Images::Downsample(image, factor, pooled);
+  return pooled;
+}
+
+}  // namespace
+
+BatchRunner::BatchRunner(const Images& training_images,
+                         const std::vector<size_t>& training_labels,
+                         const Images& test_images,
+                         const std::vector<size_t>& test_labels,
+                         size_t threads)
+    : training_images_(training_images),
+      training_labels_(training_labels),
+      test_images_(test_images),
+      test_labels_(test_labels),
+      threads_(threads) {
+  if (threads_ == 0) {
+    throw std::invalid_argument("Batch needs at least one thread");
+  }
+}
+
+std::vector<BatchJob> BatchRunner::ReadManifest(std::istream& is) {
+  if (is.fail()) {
+    throw std::invalid_argument("File does not exist or is blank");
+  }
+
+  std::vector<BatchJob> jobs;
+  std::string line;
+  size_t line_number = 0;
+  while (std::getline(is, line)) {
+    line_number++;
+    std::stringstream tokens(line.substr(0, line.find('#')));
+    BatchJob job;
+    if (!(tokens >> job.name)) {
+      continue;
+    }
+
+    std::string option;
+    while (tokens >> option) {
+      size_t equals = option.find('=');
+      std::string key = option.substr(0, equals);
+      std::string value =
+          equals == std::string::npos ? "" : option.substr(equals + 1);
+
+      // Says where every bad option is, since std::stod and std::stoul only
+      // name themselves.
+      std::string location = "Manifest line " + std::to_string(line_number) +
+                             ", option " + option + ": ";
+      try {
+        if (key == "smoothing") {
+          job.smoothing = ParseNumber(value);
+        } else if (key == "downsample") {
+          job.downsample = ParseCount(value);
+        } else if (key == "rows") {
+          ParseRange(value, job.first_row, job.end_row);
+        } else if (key == "cols") {
+          ParseRange(value, job.first_col, job.end_col);
+        } else if (key == "holdout") {
+          job.holdout = ParseNumber(value);
+        } else {
+          throw std::invalid_argument("unknown option");
+        }
+      } catch (const std::out_of_range&) {
+        throw std::invalid_argument(location + "out of range");
+      } catch (const std::invalid_argument& error) {
+        throw std::invalid_argument(location + error.what());
+      }
+    }
+    jobs.push_back(job);
+  }
+  return jobs;
+}
+
+std::vector<BatchResult> BatchRunner::Run(
+    const std::vector<BatchJob>& jobs) const {
+  std::vector<BatchResult> results(jobs.size());
+
+  WorkStealingPool pool(threads_);
+  pool.Run(jobs.size(), [this, &jobs, &results](size_t index) {
+    try {
+      results[index] = RunJob(jobs[index]);
+    } catch (const std::exception& error) {
+      results[index].job = jobs[index];
+      results[index].error = error.what();
+    }
+  });
+  return results;
+}
+
+BatchResult BatchRunner::RunJob(const BatchJob& job) const {
+  if (job.downsample == 0 || !(job.smoothing > 0) || job.holdout < 0 ||
+      job.holdout >= 1) {
+    throw std::invalid_argument("Job options are out of range");
+  }
+
+  BatchResult result;
+  result.job = job;
+
+  // A holdout evaluates on the end of the training images instead of the
+  // test images.
+  size_t training_count = std::min(training_images_.Size(),
+                                   training_labels_.size());
+  const Images* evaluation_images = &test_images_;
+  const std::vector<size_t>* evaluation_labels = &test_labels_;
+  size_t evaluation_begin = 0;
+  size_t evaluation_end = std::min(test_images_.Size(), test_labels_.size());
+  if (job.holdout > 0) {
+    evaluation_images = &training_images_;
+    evaluation_labels = &training_labels_;
+    evaluation_end = training_count;
+    training_count -= (size_t) (training_count * job.holdout);
+    evaluation_begin = training_count;
+  }
+  if (training_count == 0 || evaluation_begin == evaluation_end) {
+    throw std::invalid_argument("Job has no training or evaluation images");
+  }
+  if (job.downsample > training_images_.GetImage(0).size()) {
+    throw std::invalid_argument("Downsampling factor exceeds the image size");
+  }
+
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  CountSnapshot counts;
+  Image pooled;
+  for (size_t index = 0; index < training_count; index++) {
+    counts.AddImage(
+        PoolImage(training_images_.GetImage(index), job.downsample, pooled),
+        training_labels_[index]);
+  }
+
+  BasicTrainingModel model;
+  model.SetSmoothing(job.smoothing);
+  model.TrainModel(counts);
+  result.training_count = training_count;
+  result.training_time = MillisecondsSince(start);
+
+  // Flattened [class][row][col][shade] log probabilities of the feature
+  // window only.
+  start = std::chrono::steady_clock::now();
+  size_t pooled_size = model.image_size_;
+  size_t first_row = std::min(job.first_row, pooled_size);
+  size_t end_row = std::min(job.end_row, pooled_size);
+  size_t first_col = std::min(job.first_col, pooled_size);
+  size_t end_col = std::min(job.end_col, pooled_size);
+  if (first_row >= end_row || first_col >= end_col) {
+    throw std::invalid_argument("Feature window holds no pixels");
+  }
+
+  const std::vector<size_t>& classes = model.classes_;
+  std::vector<double> log_priors;
+  std::vector<double> log_pixels;
+  for (size_t class_num : classes) {
+    log_priors.push_back(std::log(model.GetClassProbability(class_num)));
+    for (size_t row = first_row; row < end_row; row++) {
+      for (size_t col = first_col; col < end_col; col++) {
+        for (size_t shade = 0; shade < 2; shade++) {
+          log_pixels.push_back(
+              std::log(model.GetPixelProbability(class_num, shade, row, col)));
+        }
+      }
+    }
+  }
+
+  EvaluationReport report(classes);
+  std::vector<double> scores(classes.size());
+  size_t window_size = (end_row - first_row) * (end_col - first_col) * 2;
+  for (size_t index = evaluation_begin; index < evaluation_end; index++) {
+    const Image& image = PoolImage(evaluation_images->GetImage(index),
+                                   job.downsample, pooled);
+    // The window is indexed by the trained size, so a smaller evaluation
+    // image would be read past its end.
+    bool has_trained_size = image.size() == pooled_size;
+    for (size_t row = 0; has_trained_size && row < image.size(); row++) {
+      has_trained_size = image[row].size() == pooled_size;
+    }
+    if (!has_trained_size) {
+      throw std::invalid_argument(
+          "Evaluation images are not the size of the training images");
+    }
+
+    for (size_t class_index = 0; class_index < classes.size();
+         class_index++) {
+      const double* pixel_scores = &log_pixels[class_index * window_size];
+      double score = log_priors[class_index];
+      for (size_t row = first_row; row < end_row; row++) {
+        for (size_t col = first_col; col < end_col; col++) {
+          score += pixel_scores[image[row][col] != ' '];
+          pixel_scores += 2;
+        }
+      }
+      scores[class_index] = score;
+    }
+    report.AddScores((*evaluation_labels)[index], scores);
+  }
+
+  result.evaluation_count = report.GetImageCount();
+  result.accuracy = report.GetAccuracy();
+  result.top_3_accuracy = report.GetTopKAccuracy(3);
+  result.evaluation_time = MillisecondsSince(start);
+  return result;
+}
+
+void BatchRunner::WriteReport(std::ostream& os,
+                              const std::vector<BatchResult>& results) {
+  os << std::left << std::setw(20) << "job" << std::right << std::setw(10)
+     << "smoothing" << std::setw(11) << "downsample" << std::setw(9)
+     << "rows" << std::setw(9) << "cols" << std::setw(8) << "holdout"
+     << std::setw(8) << "train" << std::setw(8) << "eval" << std::setw(10)
+     << "accuracy" << std::setw(8) << "top-3" << std::setw(11)
+     << "train ms" << std::setw(10) << "eval ms" << std::endl;
+
+  for (const BatchResult& result : results) {
+    const BatchJob& job = result.job;
+    os << std::left << std::setw(20) << job.name << std::right
+       << std::setw(10) << job.smoothing << std::setw(11) << job.downsample;
+
+    std::stringstream rows;
+    std::stringstream cols;
+    rows << job.first_row << ':';
+    cols << job.first_col << ':';
+    if (job.end_row != std::numeric_limits<size_t>::max()) {
+      rows << job.end_row;
+    }
+    if (job.end_col != std::numeric_limits<size_t>::max()) {
+      cols << job.end_col;
+    }
+    os << std::setw(9) << rows.str() << std::setw(9) << cols.str()
+       << std::setw(8) << job.holdout;
+
+    if (!result.error.empty()) {
+      os << "  failed: " << result.error << std::endl;
+      continue;
+    }
+    os << std::setw(8) << result.training_count << std::setw(8)
+       << result.evaluation_count << std::setw(10) << result.accuracy
+       << std::setw(8) << result.top_3_accuracy << std::setw(11)
+       << result.training_time << std::setw(10) << result.evaluation_time
+       << std::endl;
+  }
+}
+
+}  // namespace naivebayes
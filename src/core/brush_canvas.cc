@@ -0,0 +1,133 @@
+#include <core/brush_canvas.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace naivebayes {
+
+const char BrushCanvas::kShaded;
+const char BrushCanvas::kUnshaded;
+
+BrushCanvas::BrushCanvas(size_t num_pixels_per_side, double brush_radius)
+    : num_pixels_per_side_(num_pixels_per_side),
+      brush_radius_(brush_radius),
+      image_(num_pixels_per_side,
+             std::vector<char>(num_pixels_per_side, kUnshaded)) {
+  if (num_pixels_per_side_ == 0 || brush_radius_ < 0) {
+    throw std::invalid_argument("Canvas needs pixels and a brush radius");
+  }
+}
+
+void BrushCanvas::StartStroke(double x, double y) {
+  is_stroking_ = true;
+  last_x_ = x;
+  last_y_ = y;
+  ShadeSegment(x, y, x, y);
+}
+
+void BrushCanvas::ContinueStroke(double x, double y) {
+  if (!is_stroking_) {
+    StartStroke(x, y);
+    return;
+  }
+
+  ShadeSegment(last_x_, last_y_, x, y);
+  last_x_ = x;
+  last_y_ = y;
+}
+
+void BrushCanvas::Clear() {
+  for (std::vector<char>& row : image_) {
+    std::fill(row.begin(), row.end(), kUnshaded);
+  }
+
+  is_stroking_ = false;
+  is_dirty_ = true;
+  dirty_region_ = {0, 0, num_pixels_per_side_ - 1, num_pixels_per_side_ - 1};
+}
+
+bool BrushCanvas::IsDirty() const {
+  return is_dirty_;
+}
+
+const BrushCanvas::Region& BrushCanvas::GetDirtyRegion() const {
+  return dirty_region_;
+}
+
+void BrushCanvas::ClearDirtyRegion() {
+  is_dirty_ = false;
+}
+
+const Image& BrushCanvas::GetImage() const {
+  return image_;
+}
+
+size_t BrushCanvas::GetVisitedPixelCount() const {
+  return visited_pixel_count_;
+}
+
+void BrushCanvas::ShadeSegment(double start_x, double start_y, double end_x,
+                               double end_y) {
+  // Pixel col has its center at col + .5, so only the pixels whose centers
+  // fall inside the segment's bounding box grown by the radius can be hit.
+  double last_pixel = num_pixels_per_side_ - 1;
+  double min_col = std::ceil(std::min(start_x, end_x) - brush_radius_ - .5);
+  double max_col = std::floor(std::max(start_x, end_x) + brush_radius_ - .5);
+  double min_row = std::ceil(std::min(start_y, end_y) - brush_radius_ - .5);
+  double max_row = std::floor(std::max(start_y, end_y) + brush_radius_ - .5);
+  if (max_col < 0 || max_row < 0 || min_col > last_pixel ||
+      min_row > last_pixel) {
+    return;
+  }
+
+  size_t first_col = (size_t) std::max(min_col, 0.0);
+  size_t last_col = (size_t) std::min(max_col, last_pixel);
+  size_t first_row = (size_t) std::max(min_row, 0.0);
+  size_t last_row = (size_t) std::min(max_row, last_pixel);
+
+  double delta_x = end_x - start_x;
+  double delta_y = end_y - start_y;
+  double length_squared = delta_x * delta_x + delta_y * delta_y;
+  double radius_squared = brush_radius_ * brush_radius_;
+
+  for (size_t row = first_row; row <= last_row; row++) {
+    for (size_t col = first_col; col <= last_col; col++) {
+      double center_x = col + .5;
+      double center_y = row + .5;
+
+      // Distance from the pixel center to the closest point of the segment.
+      double t = 0;
+      if (length_squared > 0) {
+        t = ((center_x - start_x) * delta_x + (center_y - start_y) * delta_y) /
+            length_squared;
+        t = std::min(std::max(t, 0.0), 1.0);
+      }
+      double offset_x = center_x - (start_x + t * delta_x);
+      double offset_y = center_y - (start_y + t * delta_y);
+
+      if (offset_x * offset_x + offset_y * offset_y <= radius_squared &&
+          image_[row][col] != kShaded) {
+        image_[row][col] = kShaded;
+        MarkDirty(row, col);
+      }
+    }
+  }
+  visited_pixel_count_ +=
+      (last_row - first_row + 1) * (last_col - first_col + 1);
+}
+
+void BrushCanvas::MarkDirty(size_t row, size_t col) {
+  if (!is_dirty_) {
+    is_dirty_ = true;
+    dirty_region_ = {row, col, row, col};
+    return;
+  }
+
+  dirty_region_.min_row = std::min(dirty_region_.min_row, row);
+  dirty_region_.min_col = std::min(dirty_region_.min_col, col);
+  dirty_region_.max_row = std::max(dirty_region_.max_row, row);
+  dirty_region_.max_col = std::max(dirty_region_.max_col, col);
+}
+
+}  // namespace naivebayes
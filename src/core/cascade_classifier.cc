@@ -0,0 +1,163 @@
+#include <core/cascade_classifier.h>
+
+#include <algorithm>
+#include <cfloat>
+#include <stdexcept>
+#include <utility>
+
+namespace naivebayes {
+
+void CascadeClassifier::TrainModels(const Images& images,
+                                    const std::vector<size_t>& labels,
+                                    const std::vector<size_t>& factors) {
+  if (labels.size() != images.Size()) {
+    throw std::invalid_argument("Every training image needs one label");
+  }
+
+  // Counts every resolution in the same pass over the images.
+  CountSnapshot full_counts;
+  std::vector<CountSnapshot> level_counts(factors.size());
+
+  for (size_t index = 0; index < images.Size(); index++) {
+    const Image& image = images.GetImage(index);
+    full_counts.AddImage(image, labels[index]);
+
+    for (size_t level = 0; level < factors.size(); level++) {
+      Images::Downsample(image, factors[level], pooled_image_);
+      level_counts[level].AddImage(pooled_image_, labels[index]);
+    }
+  }
+
+  levels_.clear();
+  for (size_t level = 0; level < factors.size(); level++) {
+    BasicTrainingModel model;
+    model.TrainModel(level_counts[level]);
+
+    levels_.push_back(Level());
+    levels_.back().factor = factors[level];
+    levels_.back().classifier.SetModel(std::move(model));
+  }
+
+  BasicTrainingModel full_model;
+  full_model.TrainModel(full_counts);
+  full_classifier_.SetModel(std::move(full_model));
+
+  // Until tuned, nothing is resolved early.
+  thresholds_.assign(levels_.size(), DBL_MAX);
+  ResetStatistics();
+}
+
+void CascadeClassifier::TuneThresholds(const Images& images,
+                                       const double target_agreement) {
+  std::vector<size_t> full_predictions;
+  for (const Image& image : images.GetImages()) {
+    full_predictions.push_back(full_classifier_.ClassifyImage(image));
+  }
+
+  for (size_t level = 0; level < levels_.size(); level++) {
+    // Pairs of (margin, whether the level agrees with full resolution).
+    std::vector<std::pair<double, bool>> margins;
+    for (size_t index = 0; index < images.Size(); index++) {
+      Images::Downsample(images.GetImage(index), levels_[level].factor,
+                         pooled_image_);
+      double margin;
+      size_t predicted_class =
+          ClassifyWithMargin(levels_[level].classifier, pooled_image_, margin);
+      margins.emplace_back(margin, predicted_class == full_predictions[index]);
+    }
+    std::sort(margins.begin(), margins.end(),
+              [](const std::pair<double, bool>& left,
+                 const std::pair<double, bool>& right) {
+                return left.first > right.first;
+              });
+
+    // Walks from the most to the least confident image, keeping the lowest
+    // margin at which the resolved images still agree often enough.
+    thresholds_[level] = DBL_MAX;
+    size_t agree_count = 0;
+    for (size_t index = 0; index < margins.size(); index++) {
+      if (margins[index].second) {
+        agree_count++;
+      }
+      if (agree_count >= target_agreement * (index + 1)) {
+        thresholds_[level] = margins[index].first;
+      }
+    }
+  }
+}
+
+size_t CascadeClassifier::ClassifyWithMargin(const Classifier& classifier,
+                                             const Image& image,
+                                             double& margin) {
+  size_t predicted_class = 0;
+  double best_score = -DBL_MAX;
+  double second_score = -DBL_MAX;
+
+  for (size_t class_num : classifier.model_.classes_) {
+    double likelihood_score =
+        classifier.CalculateLikelihoodScore(class_num, image);
+
+    if (best_score < likelihood_score) {
+      second_score = best_score;
+      best_score = likelihood_score;
+      predicted_class = class_num;
+    } else if (second_score < likelihood_score) {
+      second_score = likelihood_score;
+    }
+  }
+
+  margin = best_score - second_score;
+  return predicted_class;
+}
+
+size_t CascadeClassifier::ClassifyImage(const Image& image) {
+  image_count_++;
+
+  for (size_t level = 0; level < levels_.size(); level++) {
+    Images::Downsample(image, levels_[level].factor, pooled_image_);
+    double margin;
+    size_t predicted_class =
+        ClassifyWithMargin(levels_[level].classifier, pooled_image_, margin);
+
+    if (margin >= thresholds_[level]) {
+      early_count_++;
+      return predicted_class;
+    }
+  }
+
+  return full_classifier_.ClassifyImage(image);
+}
+
+double CascadeClassifier::CalculateAccuracy(
+    const Images& images_to_classify,
+    const std::vector<size_t>& expected_classes) {
+  size_t correct_count = 0;
+
+  for (size_t index = 0; index < expected_classes.size(); index++) {
+    if (ClassifyImage(images_to_classify.GetImage(index)) ==
+        expected_classes[index]) {
+      correct_count++;
+    }
+  }
+
+  return ((double) correct_count) / (expected_classes.size());
+}
+
+double CascadeClassifier::GetEarlyFraction() const {
+  return image_count_ == 0 ? 0 : ((double) early_count_) / image_count_;
+}
+
+void CascadeClassifier::ResetStatistics() {
+  early_count_ = 0;
+  image_count_ = 0;
+}
+
+const Classifier& CascadeClassifier::GetFullClassifier() const {
+  return full_classifier_;
+}
+
+const std::vector<double>& CascadeClassifier::GetThresholds() const {
+  return thresholds_;
+}
+
+}  // namespace naivebayes
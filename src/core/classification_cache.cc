@@ -0,0 +1,123 @@
+#include <core/classification_cache.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace naivebayes {
+
+const size_t ClassificationCache::kMaxImageSize;
+
+ClassificationCache::ClassificationCache(const Classifier& classifier,
+                                         size_t capacity, size_t shard_count)
+    : classifier_(classifier), model_version_(0), hits_(0), misses_(0) {
+  if (capacity == 0 || shard_count == 0) {
+    throw std::invalid_argument("Cache capacity and shards must be positive");
+  }
+
+  shard_count = std::min(shard_count, capacity);
+  shard_capacity_ = (capacity + shard_count - 1) / shard_count;
+  for (size_t shard = 0; shard < shard_count; shard++) {
+    shards_.emplace_back(new Shard());
+  }
+}
+
+uint64_t ClassificationCache::HashImage(const uint64_t* packed_rows,
+                                        size_t row_count,
+                                        uint64_t model_version) {
+  // FNV-1a over whole rows, finished with the splitmix64 mixer so that
+  // nearby images spread across shards.
+  uint64_t hash = 14695981039346656037ULL ^ model_version;
+  for (size_t row = 0; row < row_count; row++) {
+    hash = (hash ^ packed_rows[row]) * 1099511628211ULL;
+  }
+
+  hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebULL;
+  return hash ^ (hash >> 31);
+}
+
+size_t ClassificationCache::ClassifyImage(const Image& image) {
+  // Images too big to pack, including any with a row wider than a word, are
+  // classified without being cached.
+  bool is_packable = image.size() <= kMaxImageSize;
+  for (size_t row = 0; is_packable && row < image.size(); row++) {
+    is_packable = image[row].size() <= kMaxImageSize;
+  }
+  if (!is_packable) {
+    misses_++;
+    return classifier_.ClassifyImage(image);
+  }
+
+  // Packs into a fixed buffer so a hit never allocates.
+  uint64_t packed_rows[kMaxImageSize];
+  size_t row_count = image.size();
+  Images::PackImage(image, packed_rows);
+
+  uint64_t key = HashImage(packed_rows, row_count, model_version_.load());
+  Shard& shard = *shards_[key % shards_.size()];
+
+  {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    std::unordered_map<uint64_t, std::list<Entry>::iterator>::iterator found =
+        shard.index.find(key);
+
+    if (found != shard.index.end() &&
+        found->second->image.size() == row_count &&
+        std::equal(packed_rows, packed_rows + row_count,
+                   found->second->image.begin())) {
+      shard.entries.splice(shard.entries.begin(), shard.entries,
+                           found->second);
+      hits_++;
+      return found->second->predicted_class;
+    }
+  }
+
+  // Classifies without holding the lock so other threads are not blocked.
+  misses_++;
+  size_t predicted_class = classifier_.ClassifyImage(image);
+
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  std::unordered_map<uint64_t, std::list<Entry>::iterator>::iterator found =
+      shard.index.find(key);
+  if (found != shard.index.end()) {
+    shard.entries.erase(found->second);
+    shard.index.erase(found);
+  }
+
+  Entry entry;
+  entry.key = key;
+  entry.image.assign(packed_rows, packed_rows + row_count);
+  entry.predicted_class = predicted_class;
+  shard.entries.push_front(std::move(entry));
+  shard.index[key] = shard.entries.begin();
+
+  if (shard.entries.size() > shard_capacity_) {
+    shard.index.erase(shard.entries.back().key);
+    shard.entries.pop_back();
+  }
+  return predicted_class;
+}
+
+void ClassificationCache::SetModelVersion(uint64_t model_version) {
+  model_version_.store(model_version);
+}
+
+size_t ClassificationCache::GetHits() const {
+  return hits_.load();
+}
+
+size_t ClassificationCache::GetMisses() const {
+  return misses_.load();
+}
+
+size_t ClassificationCache::Size() const {
+  size_t size = 0;
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    size += shard->entries.size();
+  }
+  return size;
+}
+
+}  // namespace naivebayes
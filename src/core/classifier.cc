@@ -1,10 +1,14 @@
 #include <core/classifier.h>
+#include <core/input_file.h>
 
-#include <fstream>
+#include <cfloat>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
 
 namespace naivebayes {
 
-size_t Classifier::ClassifyImage(const Image& image) {
+size_t Classifier::ClassifyImage(const Image& image) const {
   size_t predicted_class = 0;
   double temp = -DBL_MAX;
 
@@ -20,7 +24,8 @@ size_t Classifier::ClassifyImage(const Image& image) {
   return predicted_class;
 }
 
-double Classifier::CalculateLikelihoodScore(const size_t class_num, const Image image) {
+double Classifier::CalculateLikelihoodScore(const size_t class_num,
+                                            const Image& image) const {
   double likelihood_score = 0;
 
   likelihood_score += log10(model_.GetClassProbability(class_num));
@@ -42,8 +47,8 @@ double Classifier::CalculateLikelihoodScore(const size_t class_num, const Image
   return likelihood_score;
 }
 
-double Classifier::CalculateAccuracy(const Images& images_to_classify) {
-  std::vector<Image> images = images_to_classify.GetImages();
+double Classifier::CalculateAccuracy(const Images& images_to_classify) const {
+  const std::vector<Image>& images = images_to_classify.GetImages();
   size_t correct_count = 0;
 
   for (size_t index = 0; index < expected_class_.size(); index++) {
@@ -58,7 +63,7 @@ double Classifier::CalculateAccuracy(const Images& images_to_classify) {
 
 void Classifier::ReadLabels(const std::string& file_path) {
   size_t label;
-  std::ifstream is(file_path);
+  InputFile is(file_path);
 
   if (is.fail()) {
     throw std::invalid_argument("File does not exist or is blank");
@@ -68,8 +73,17 @@ void Classifier::ReadLabels(const std::string& file_path) {
     expected_class_.push_back(label);
   }
 }
-void Classifier::SetModel(BasicTrainingModel model) {
+
+const std::vector<size_t>& Classifier::GetExpectedClasses() const {
+  return expected_class_;
+}
+
+void Classifier::SetModel(const BasicTrainingModel& model) {
   model_ = model;
 }
 
+void Classifier::SetModel(BasicTrainingModel&& model) {
+  model_ = std::move(model);
+}
+
 }  // namespace naivebayes
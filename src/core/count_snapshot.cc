@@ -0,0 +1,235 @@
+#include <core/count_snapshot.h>
+
+#include <cstdlib>
+#include <stdexcept>
+
+namespace naivebayes {
+
+const size_t CountSnapshot::kMaxPackedSize;
+
+std::istream& operator>>(std::istream& is, CountSnapshot& counts) {
+  if (is.fail()) {
+    throw std::invalid_argument("File does not exist or is blank");
+  }
+
+  size_t num_classes;
+  is >> counts.image_size_ >> num_classes;
+
+  std::vector<size_t> classes;
+  for (size_t index = 0; index < num_classes; index++) {
+    size_t class_number;
+    is >> class_number;
+    classes.push_back(class_number);
+  }
+
+  counts.image_count_ = 0;
+  counts.class_sizes_.clear();
+  counts.unshaded_counts_.clear();
+  for (size_t class_number : classes) {
+    is >> counts.class_sizes_[class_number];
+    counts.image_count_ += counts.class_sizes_[class_number];
+  }
+
+  size_t pixel_count = counts.image_size_ * counts.image_size_;
+  for (size_t class_number : classes) {
+    std::vector<size_t>& class_counts = counts.unshaded_counts_[class_number];
+    class_counts.resize(pixel_count);
+    for (size_t pixel = 0; pixel < pixel_count; pixel++) {
+      is >> class_counts[pixel];
+    }
+  }
+
+  if (is.fail()) {
+    throw std::invalid_argument("Count snapshot is incomplete");
+  }
+  return is;
+}
+
+std::ostream& operator<<(std::ostream& os, const CountSnapshot& counts) {
+  os << counts.image_size_ << std::endl
+     << counts.class_sizes_.size() << std::endl;
+
+  for (const std::pair<const size_t, size_t>& class_size :
+       counts.class_sizes_) {
+    os << class_size.first << std::endl;
+  }
+  for (const std::pair<const size_t, size_t>& class_size :
+       counts.class_sizes_) {
+    os << class_size.second << std::endl;
+  }
+
+  for (const std::pair<const size_t, std::vector<size_t>>& class_counts :
+       counts.unshaded_counts_) {
+    for (size_t count : class_counts.second) {
+      os << count << std::endl;
+    }
+  }
+  return os;
+}
+
+std::vector<size_t>& CountSnapshot::GetOrAddCounts(const size_t class_number) {
+  std::vector<size_t>& class_counts = unshaded_counts_[class_number];
+  class_counts.resize(image_size_ * image_size_, 0);
+  return class_counts;
+}
+
+void CountSnapshot::CheckImageSize(const Image& image) {
+  size_t image_size = class_sizes_.empty() ? image.size() : image_size_;
+  if (image.size() != image_size) {
+    throw std::invalid_argument("Every image must be the same size");
+  }
+  // A short row would be read past its end and a long one counted in part.
+  for (const std::vector<char>& row : image) {
+    if (row.size() != image_size) {
+      throw std::invalid_argument("Every image must be square");
+    }
+  }
+  image_size_ = image_size;
+}
+
+void CountSnapshot::AddImage(const Image& image, size_t label) {
+  CheckImageSize(image);
+
+  std::vector<size_t>& class_counts = GetOrAddCounts(label);
+  for (size_t row = 0; row < image_size_; row++) {
+    for (size_t col = 0; col < image_size_; col++) {
+      if (image[row][col] == ' ') {
+        class_counts[row * image_size_ + col]++;
+      }
+    }
+  }
+
+  class_sizes_[label]++;
+  image_count_++;
+}
+
+void CountSnapshot::AddImages(const Images& images,
+                              const std::vector<size_t>& labels, size_t begin,
+                              size_t end) {
+  if (end > images.Size() || end > labels.size()) {
+    throw std::invalid_argument("Every image needs a label");
+  }
+
+  for (size_t index = begin; index < end; index++) {
+    AddImage(images.GetImage(index), labels[index]);
+  }
+}
+
+void CountSnapshot::AddImage(const Image& image, size_t label,
+                             const std::vector<ImageShift>& shifts) {
+  // Adds no images, so the label must not become a class.
+  if (shifts.empty()) {
+    return;
+  }
+  if (image.size() > kMaxPackedSize) {
+    throw std::invalid_argument("Shifted images are at most 64 pixels wide");
+  }
+  // Every row is as wide as the image, so no packed row holds bits past it.
+  CheckImageSize(image);
+
+  uint64_t row_mask = image_size_ == kMaxPackedSize
+                          ? ~(uint64_t) 0
+                          : ((uint64_t) 1 << image_size_) - 1;
+  uint64_t packed_rows[kMaxPackedSize];
+  Images::PackImage(image, packed_rows);
+
+  std::vector<size_t>& class_counts = GetOrAddCounts(label);
+
+  for (const ImageShift& shift : shifts) {
+    for (size_t row = 0; row < image_size_; row++) {
+      // The row shifted into this one, moved along by the column offset.
+      long source_row = (long) row - shift.rows;
+      uint64_t bits = 0;
+      if (source_row >= 0 && source_row < (long) image_size_ &&
+          std::abs(shift.cols) < (int) kMaxPackedSize) {
+        bits = shift.cols >= 0 ? packed_rows[source_row] << shift.cols
+                               : packed_rows[source_row] >> -shift.cols;
+        bits &= row_mask;
+      }
+
+      size_t* row_counts = &class_counts[row * image_size_];
+      for (size_t col = 0; col < image_size_; col++) {
+        row_counts[col] += ((bits >> col) & 1) ^ 1;
+      }
+    }
+  }
+
+  class_sizes_[label] += shifts.size();
+  image_count_ += shifts.size();
+}
+
+void CountSnapshot::AddImages(const Images& images,
+                              const std::vector<size_t>& labels, size_t begin,
+                              size_t end,
+                              const std::vector<ImageShift>& shifts) {
+  if (end > images.Size() || end > labels.size()) {
+    throw std::invalid_argument("Every image needs a label");
+  }
+
+  for (size_t index = begin; index < end; index++) {
+    AddImage(images.GetImage(index), labels[index], shifts);
+  }
+}
+
+std::vector<ImageShift> CountSnapshot::MakeShifts(size_t max_offset) {
+  std::vector<ImageShift> shifts;
+  int offset = (int) max_offset;
+  for (int rows = -offset; rows <= offset; rows++) {
+    for (int cols = -offset; cols <= offset; cols++) {
+      shifts.push_back({rows, cols});
+    }
+  }
+  return shifts;
+}
+
+void CountSnapshot::Merge(const CountSnapshot& other) {
+  if (other.class_sizes_.empty()) {
+    return;
+  }
+  if (class_sizes_.empty()) {
+    image_size_ = other.image_size_;
+  } else if (other.image_size_ != image_size_) {
+    throw std::invalid_argument("Snapshots have different image sizes");
+  }
+
+  for (const std::pair<const size_t, size_t>& class_size :
+       other.class_sizes_) {
+    class_sizes_[class_size.first] += class_size.second;
+
+    std::vector<size_t>& class_counts = GetOrAddCounts(class_size.first);
+    const std::vector<size_t>& other_counts =
+        other.unshaded_counts_.at(class_size.first);
+    for (size_t pixel = 0; pixel < class_counts.size(); pixel++) {
+      class_counts[pixel] += other_counts[pixel];
+    }
+  }
+  image_count_ += other.image_count_;
+}
+
+size_t CountSnapshot::GetImageSize() const {
+  return image_size_;
+}
+
+size_t CountSnapshot::GetImageCount() const {
+  return image_count_;
+}
+
+std::vector<size_t> CountSnapshot::GetClasses() const {
+  std::vector<size_t> classes;
+  for (const std::pair<const size_t, size_t>& class_size : class_sizes_) {
+    classes.push_back(class_size.first);
+  }
+  return classes;
+}
+
+size_t CountSnapshot::GetClassSize(const size_t class_number) const {
+  return class_sizes_.at(class_number);
+}
+
+size_t CountSnapshot::GetUnshadedCount(const size_t class_number,
+                                       const size_t row,
+                                       const size_t col) const {
+  return unshaded_counts_.at(class_number).at(row * image_size_ + col);
+}
+
+}  // namespace naivebayes
@@ -0,0 +1,138 @@
+#include <core/dataset_generator.h>
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace naivebayes {
+
+namespace {
+
+/**
+ * Draws a double in [0, 1) from the top 53 bits of the generator, which
+ * unlike std::uniform_real_distribution gives the same values with every
+ * standard library.
+ */
+double NextUniform(std::mt19937_64& generator) {
+  return (generator() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+}  // namespace
+
+const size_t DatasetGenerator::kChunkSize;
+
+DatasetGenerator::DatasetGenerator(const BasicTrainingModel& model,
+                                   uint64_t seed, size_t threads)
+    : seed_(seed),
+      threads_(threads),
+      image_size_(model.image_size_),
+      classes_(model.classes_) {
+  if (threads_ == 0 || classes_.empty()) {
+    throw std::invalid_argument("Generating needs a model and a thread");
+  }
+
+  double total = 0;
+  for (size_t class_num : classes_) {
+    total += model.GetClassProbability(class_num);
+    cumulative_class_probabilities_.push_back(total);
+
+    for (size_t row = 0; row < image_size_; row++) {
+      for (size_t col = 0; col < image_size_; col++) {
+        shaded_probabilities_.push_back(
+            model.GetPixelProbability(class_num, 1, row, col));
+      }
+    }
+  }
+  for (double& probability : cumulative_class_probabilities_) {
+    probability /= total;
+  }
+}
+
+void DatasetGenerator::Generate(size_t image_count, ImageFormat format,
+                                std::ostream& images_os,
+                                std::ostream& labels_os) const {
+  if (format == ImageFormat::kPacked) {
+    Images::WritePackedHeader(images_os, image_size_);
+  }
+
+  size_t chunk_count = (image_count + kChunkSize - 1) / kChunkSize;
+  std::vector<std::string> images(threads_);
+  std::vector<std::string> labels(threads_);
+
+  // Generates one round of up to threads_ chunks in parallel, then writes
+  // them in chunk order.
+  for (size_t first_chunk = 0; first_chunk < chunk_count;
+       first_chunk += threads_) {
+    size_t round_size = std::min(threads_, chunk_count - first_chunk);
+    std::vector<std::thread> workers;
+
+    for (size_t slot = 0; slot < round_size; slot++) {
+      size_t chunk_index = first_chunk + slot;
+      size_t count =
+          std::min(kChunkSize, image_count - chunk_index * kChunkSize);
+
+      workers.emplace_back([this, chunk_index, count, format, slot, &images,
+                            &labels]() {
+        GenerateChunk(chunk_index, count, format, images[slot], labels[slot]);
+      });
+    }
+
+    for (size_t slot = 0; slot < round_size; slot++) {
+      workers[slot].join();
+      images_os.write(images[slot].data(), images[slot].size());
+      labels_os.write(labels[slot].data(), labels[slot].size());
+    }
+  }
+}
+
+void DatasetGenerator::GenerateChunk(size_t chunk_index, size_t count,
+                                     ImageFormat format, std::string& images,
+                                     std::string& labels) const {
+  std::seed_seq seeds = {(uint32_t) seed_, (uint32_t) (seed_ >> 32),
+                         (uint32_t) chunk_index,
+                         (uint32_t) ((uint64_t) chunk_index >> 32)};
+  std::mt19937_64 generator(seeds);
+
+  size_t pixel_count = image_size_ * image_size_;
+  size_t row_bytes = (image_size_ + 7) / 8;
+  images.clear();
+  labels.clear();
+
+  for (size_t index = 0; index < count; index++) {
+    size_t class_index =
+        std::upper_bound(cumulative_class_probabilities_.begin(),
+                         cumulative_class_probabilities_.end() - 1,
+                         NextUniform(generator)) -
+        cumulative_class_probabilities_.begin();
+    labels += std::to_string(classes_[class_index]);
+    labels += '\n';
+
+    const double* probabilities =
+        &shaded_probabilities_[class_index * pixel_count];
+    for (size_t row = 0; row < image_size_; row++) {
+      size_t row_start = images.size();
+      if (format == ImageFormat::kPacked) {
+        images.append(row_bytes, '\0');
+      }
+
+      for (size_t col = 0; col < image_size_; col++) {
+        bool is_shaded =
+            NextUniform(generator) < probabilities[row * image_size_ + col];
+        if (format == ImageFormat::kPacked) {
+          if (is_shaded) {
+            images[row_start + col / 8] |= (char) (1 << (col % 8));
+          }
+        } else {
+          images += is_shaded ? '#' : ' ';
+        }
+      }
+
+      if (format == ImageFormat::kAscii) {
+        images += '\n';
+      }
+    }
+  }
+}
+
+}  // namespace naivebayes
@@ -0,0 +1,229 @@
+#include <core/evaluation_report.h>
+
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+namespace naivebayes {
+
+EvaluationReport::EvaluationReport(const std::vector<size_t>& classes,
+                                   size_t top_k, size_t margin_bins,
+                                   double margin_bin_width)
+    : classes_(classes),
+      margin_bin_width_(margin_bin_width),
+      confusion_(classes.size() * classes.size(), 0),
+      rank_counts_(top_k, 0),
+      margin_histogram_(margin_bins, 0) {
+  if (classes_.empty() || top_k == 0 || margin_bins == 0 ||
+      !(margin_bin_width_ > 0)) {
+    throw std::invalid_argument("Report needs classes, k and margin bins");
+  }
+}
+
+void EvaluationReport::AddScores(size_t label,
+                                 const std::vector<double>& scores) {
+  if (scores.size() != classes_.size()) {
+    throw std::invalid_argument("Need one score per class");
+  }
+
+  image_count_++;
+  size_t actual = FindClassIndex(label);
+  if (actual == classes_.size()) {
+    unknown_label_count_++;
+    return;
+  }
+
+  size_t predicted = 0;
+  double best = scores[0];
+  double second_best = -std::numeric_limits<double>::infinity();
+
+  // The true class ranks behind every higher score and every equal score
+  // of an earlier class, matching how ties are broken when classifying.
+  size_t rank = 0;
+  for (size_t index = 0; index < scores.size(); index++) {
+    if (scores[index] > scores[actual] ||
+        (scores[index] == scores[actual] && index < actual)) {
+      rank++;
+    }
+
+    if (index == 0) {
+      continue;
+    }
+    if (scores[index] > best) {
+      second_best = best;
+      best = scores[index];
+      predicted = index;
+    } else if (scores[index] > second_best) {
+      second_best = scores[index];
+    }
+  }
+
+  confusion_[actual * classes_.size() + predicted]++;
+  if (rank < rank_counts_.size()) {
+    rank_counts_[rank]++;
+  }
+
+  double margin = classes_.size() > 1 ? best - second_best : 0;
+  size_t bin = margin_histogram_.size() - 1;
+  if (margin < bin * margin_bin_width_) {
+    bin = (size_t) (margin / margin_bin_width_);
+  }
+  margin_histogram_[bin]++;
+}
+
+void EvaluationReport::Merge(const EvaluationReport& other) {
+  if (other.classes_ != classes_ ||
+      other.rank_counts_.size() != rank_counts_.size() ||
+      other.margin_histogram_.size() != margin_histogram_.size() ||
+      other.margin_bin_width_ != margin_bin_width_) {
+    throw std::invalid_argument("Reports are not over the same classes");
+  }
+
+  image_count_ += other.image_count_;
+  unknown_label_count_ += other.unknown_label_count_;
+  for (size_t index = 0; index < confusion_.size(); index++) {
+    confusion_[index] += other.confusion_[index];
+  }
+  for (size_t rank = 0; rank < rank_counts_.size(); rank++) {
+    rank_counts_[rank] += other.rank_counts_[rank];
+  }
+  for (size_t bin = 0; bin < margin_histogram_.size(); bin++) {
+    margin_histogram_[bin] += other.margin_histogram_[bin];
+  }
+}
+
+size_t EvaluationReport::GetImageCount() const {
+  return image_count_;
+}
+
+size_t EvaluationReport::GetUnknownLabelCount() const {
+  return unknown_label_count_;
+}
+
+double EvaluationReport::GetAccuracy() const {
+  return GetTopKAccuracy(1);
+}
+
+double EvaluationReport::GetTopKAccuracy(size_t k) const {
+  if (k == 0 || k > rank_counts_.size()) {
+    throw std::invalid_argument("k is not tracked by this report");
+  }
+  if (image_count_ == 0) {
+    return 0;
+  }
+
+  size_t hits = 0;
+  for (size_t rank = 0; rank < k; rank++) {
+    hits += rank_counts_[rank];
+  }
+  return ((double) hits) / image_count_;
+}
+
+size_t EvaluationReport::GetConfusionCount(size_t actual,
+                                           size_t predicted) const {
+  return confusion_[GetClassIndex(actual) * classes_.size() +
+                    GetClassIndex(predicted)];
+}
+
+double EvaluationReport::GetPrecision(size_t class_num) const {
+  size_t index = GetClassIndex(class_num);
+  size_t predicted_count = 0;
+  for (size_t actual = 0; actual < classes_.size(); actual++) {
+    predicted_count += confusion_[actual * classes_.size() + index];
+  }
+
+  if (predicted_count == 0) {
+    return 0;
+  }
+  return ((double) confusion_[index * classes_.size() + index]) /
+         predicted_count;
+}
+
+double EvaluationReport::GetRecall(size_t class_num) const {
+  size_t index = GetClassIndex(class_num);
+  size_t actual_count = 0;
+  for (size_t predicted = 0; predicted < classes_.size(); predicted++) {
+    actual_count += confusion_[index * classes_.size() + predicted];
+  }
+
+  if (actual_count == 0) {
+    return 0;
+  }
+  return ((double) confusion_[index * classes_.size() + index]) /
+         actual_count;
+}
+
+const std::vector<size_t>& EvaluationReport::GetMarginHistogram() const {
+  return margin_histogram_;
+}
+
+const std::vector<size_t>& EvaluationReport::GetClasses() const {
+  return classes_;
+}
+
+size_t EvaluationReport::FindClassIndex(size_t class_num) const {
+  size_t index = 0;
+  while (index < classes_.size() && classes_[index] != class_num) {
+    index++;
+  }
+  return index;
+}
+
+size_t EvaluationReport::GetClassIndex(size_t class_num) const {
+  size_t index = FindClassIndex(class_num);
+  if (index == classes_.size()) {
+    throw std::invalid_argument("Class is not in the report");
+  }
+  return index;
+}
+
+std::ostream& operator<<(std::ostream& os, const EvaluationReport& report) {
+  os << "Images: " << report.image_count_ << std::endl;
+  if (report.unknown_label_count_ > 0) {
+    os << "Images with an unknown label: " << report.unknown_label_count_
+       << std::endl;
+  }
+  for (size_t k = 1; k <= report.rank_counts_.size(); k++) {
+    os << "Top-" << k << " accuracy: " << report.GetTopKAccuracy(k)
+       << std::endl;
+  }
+
+  os << std::setw(8) << "class" << std::setw(12) << "precision"
+     << std::setw(12) << "recall" << std::endl;
+  for (size_t class_num : report.classes_) {
+    os << std::setw(8) << class_num << std::setw(12)
+       << report.GetPrecision(class_num) << std::setw(12)
+       << report.GetRecall(class_num) << std::endl;
+  }
+
+  os << "Confusion matrix (rows are true classes):" << std::endl;
+  os << std::setw(8) << "";
+  for (size_t class_num : report.classes_) {
+    os << std::setw(7) << class_num;
+  }
+  os << std::endl;
+  for (size_t actual = 0; actual < report.classes_.size(); actual++) {
+    os << std::setw(8) << report.classes_[actual];
+    for (size_t predicted = 0; predicted < report.classes_.size();
+         predicted++) {
+      os << std::setw(7)
+         << report.confusion_[actual * report.classes_.size() + predicted];
+    }
+    os << std::endl;
+  }
+
+  os << "Margin between the two best scores:" << std::endl;
+  for (size_t bin = 0; bin < report.margin_histogram_.size(); bin++) {
+    double low = bin * report.margin_bin_width_;
+    os << std::setw(8) << low;
+    if (bin + 1 < report.margin_histogram_.size()) {
+      os << " - " << std::setw(6) << low + report.margin_bin_width_;
+    } else {
+      os << " +      ";
+    }
+    os << std::setw(8) << report.margin_histogram_[bin] << std::endl;
+  }
+  return os;
+}
+
+}  // namespace naivebayes
@@ -1,37 +1,163 @@
 #include <core/images.h>
 
+#include <algorithm>
+#include <stdexcept>
 #include <string>
+#include <utility>
 
 namespace naivebayes {
 
+namespace {
+const char kPackedMagic[] = {'N', 'B', 'P', 'K'};
+}  // namespace
+
 std::istream& operator>>(std::istream& is, Images& data) {
-  std::string line;
   // A 2d vector representing an n x n ascii image.
-  std::vector<std::vector<char>> image;
+  Image image;
 
   if (is.fail()) {
     throw std::invalid_argument("File does not exist or is blank");
   }
 
+  while (Images::ReadImage(is, image)) {
+    data.images_.push_back(std::move(image));
+  }
+  return is;
+}
+
+bool Images::ReadImage(std::istream& is, Image& image) {
+  std::string line;
+  image.clear();
+
   while (getline(is, line)) {
     // Creates a vector of characters from the read line
-    std::vector<char> line_char(line.begin(), line.end());
-    image.push_back(line_char);
+    image.emplace_back(line.begin(), line.end());
 
     // Every image is square, so if # of rows == # of characters in column,
     // image is complete and the next line will start the next image.
     if (image.size() == line.length()) {
-      data.images_.push_back(image);
-      image.clear();
+      return true;
     }
   }
-  return is;
+  return false;
 }
 
-std::vector<Image> Images::GetImages() const {
+void Images::Downsample(const Image& image, const size_t factor,
+                        Image& pooled) {
+  if (factor == 0) {
+    throw std::invalid_argument("Downsampling factor must be positive");
+  }
+
+  // Rounds up without adding to the size, which could overflow for huge
+  // factors.
+  size_t pooled_size = image.size() / factor + (image.size() % factor != 0);
+  pooled.resize(pooled_size);
+  for (std::vector<char>& row : pooled) {
+    row.assign(pooled_size, ' ');
+  }
+
+  for (size_t row = 0; row < image.size(); row++) {
+    for (size_t col = 0; col < image[row].size(); col++) {
+      if (image[row][col] != ' ') {
+        pooled[row / factor][col / factor] = '#';
+      }
+    }
+  }
+}
+
+void Images::PackImage(const Image& image, uint64_t* packed_rows) {
+  for (size_t row = 0; row < image.size(); row++) {
+    if (image[row].size() > 64) {
+      throw std::invalid_argument("Packed images are at most 64 pixels wide");
+    }
+
+    uint64_t bits = 0;
+    for (size_t col = 0; col < image[row].size(); col++) {
+      bits |= (uint64_t) (image[row][col] != ' ') << col;
+    }
+    packed_rows[row] = bits;
+  }
+}
+
+void Images::WritePackedHeader(std::ostream& os, const size_t image_size) {
+  os.write(kPackedMagic, sizeof(kPackedMagic));
+  for (size_t byte = 0; byte < 4; byte++) {
+    os.put((char) ((image_size >> (8 * byte)) & 0xff));
+  }
+}
+
+size_t Images::ReadPackedHeader(std::istream& is) {
+  if (is.fail()) {
+    throw std::invalid_argument("File does not exist or is blank");
+  }
+
+  char header[sizeof(kPackedMagic) + 4];
+  if (!is.read(header, sizeof(header)) ||
+      !std::equal(kPackedMagic, kPackedMagic + sizeof(kPackedMagic), header)) {
+    throw std::invalid_argument("Stream is not in the packed image format");
+  }
+
+  size_t image_size = 0;
+  for (size_t byte = 0; byte < 4; byte++) {
+    image_size |= (size_t) (unsigned char) header[sizeof(kPackedMagic) + byte]
+                  << (8 * byte);
+  }
+  return image_size;
+}
+
+void Images::WritePackedImage(std::ostream& os, const Image& image) {
+  size_t row_bytes = (image.size() + 7) / 8;
+  std::vector<char> packed_row(row_bytes);
+
+  for (const std::vector<char>& row : image) {
+    std::fill(packed_row.begin(), packed_row.end(), 0);
+    for (size_t col = 0; col < row.size(); col++) {
+      if (row[col] != ' ') {
+        packed_row[col / 8] |= (char) (1 << (col % 8));
+      }
+    }
+    os.write(packed_row.data(), row_bytes);
+  }
+}
+
+bool Images::ReadPackedImage(std::istream& is, const size_t image_size,
+                             Image& image) {
+  size_t row_bytes = (image_size + 7) / 8;
+  char packed_row[8];
+  if (image_size == 0) {
+    // Would read nothing and succeed forever.
+    throw std::invalid_argument("Packed images must have at least one pixel");
+  }
+  if (row_bytes > sizeof(packed_row)) {
+    throw std::invalid_argument("Packed images are at most 64 pixels wide");
+  }
+
+  image.resize(image_size);
+  for (std::vector<char>& row : image) {
+    if (!is.read(packed_row, row_bytes)) {
+      return false;
+    }
+
+    row.resize(image_size);
+    for (size_t col = 0; col < image_size; col++) {
+      row[col] = (packed_row[col / 8] >> (col % 8)) & 1 ? '#' : ' ';
+    }
+  }
+  return true;
+}
+
+const std::vector<Image>& Images::GetImages() const {
   return images_;
 }
 
+const Image& Images::GetImage(const size_t image_index) const {
+  return images_.at(image_index);
+}
+
+size_t Images::Size() const {
+  return images_.size();
+}
+
 char Images::GetPixel(const size_t image_index, const size_t row,
                       const size_t col) const {
   return images_.at(image_index).at(row).at(col);
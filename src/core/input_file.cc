@@ -0,0 +1,289 @@
+#include <core/input_file.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#ifdef NAIVEBAYES_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef NAIVEBAYES_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace naivebayes {
+
+namespace {
+
+// Compressed bytes read at a time, and the most decompressed bytes per
+// chunk.
+const size_t kInputSize = 1 << 16;
+const size_t kChunkSize = 1 << 18;
+
+#ifdef NAIVEBAYES_HAVE_ZLIB
+/**
+ * Checks that the unread input and everything left in the source are zero
+ * bytes, which some tools pad compressed files with.
+ *
+ * @param data The unread part of the input buffer
+ * @param size Number of unread bytes
+ * @param input Buffer the rest of the source is read through
+ */
+bool IsZeroPadding(std::istream& source, const char* data, size_t size,
+                   std::vector<char>& input) {
+  while (true) {
+    if (std::find_if(data, data + size, [](char byte) { return byte != 0; }) !=
+        data + size) {
+      return false;
+    }
+
+    source.read(input.data(), input.size());
+    size = (size_t) source.gcount();
+    if (size == 0) {
+      return true;
+    }
+    data = input.data();
+  }
+}
+#endif
+
+}  // namespace
+
+DecompressingStreambuf::DecompressingStreambuf(std::istream& source,
+                                               Compression compression,
+                                               size_t queue_capacity)
+    : queue_capacity_(queue_capacity) {
+  if (queue_capacity_ == 0) {
+    throw std::invalid_argument("Queue capacity must be greater than zero");
+  }
+
+  setg(nullptr, nullptr, nullptr);
+  decompressor_ = std::thread([this, &source, compression]() {
+    Decompress(source, compression);
+  });
+}
+
+DecompressingStreambuf::~DecompressingStreambuf() {
+  {
+    std::lock_guard<std::mutex> lock(chunks_mutex_);
+    is_stopping_ = true;
+  }
+  chunk_popped_.notify_all();
+  decompressor_.join();
+}
+
+Compression DecompressingStreambuf::DetectCompression(std::istream& source) {
+  unsigned char magic[4] = {0, 0, 0, 0};
+  std::streampos start = source.tellg();
+  source.read(reinterpret_cast<char*>(magic), sizeof(magic));
+  source.clear();
+  source.seekg(start);
+
+  if (magic[0] == 0x1f && magic[1] == 0x8b) {
+    return Compression::kGzip;
+  }
+  if (magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f &&
+      magic[3] == 0xfd) {
+    return Compression::kZstd;
+  }
+  return Compression::kNone;
+}
+
+DecompressingStreambuf::int_type DecompressingStreambuf::underflow() {
+  while (gptr() == egptr()) {
+    if (current_.is_last) {
+      if (!current_.error.empty()) {
+        throw std::invalid_argument(current_.error);
+      }
+      return traits_type::eof();
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(chunks_mutex_);
+      chunk_pushed_.wait(lock, [this]() { return !chunks_.empty(); });
+      current_ = std::move(chunks_.front());
+      chunks_.pop_front();
+    }
+    chunk_popped_.notify_one();
+
+    char* data = &current_.data[0];
+    setg(data, data, data + current_.data.size());
+  }
+  return traits_type::to_int_type(*gptr());
+}
+
+bool DecompressingStreambuf::PushChunk(Chunk&& chunk) {
+  {
+    std::unique_lock<std::mutex> lock(chunks_mutex_);
+    chunk_popped_.wait(lock, [this]() {
+      return is_stopping_ || chunks_.size() < queue_capacity_;
+    });
+    if (is_stopping_) {
+      return false;
+    }
+    chunks_.push_back(std::move(chunk));
+  }
+  chunk_pushed_.notify_one();
+  return true;
+}
+
+void DecompressingStreambuf::Decompress(std::istream& source,
+                                        Compression compression) {
+  Chunk last;
+  last.is_last = true;
+  std::vector<char> input(kInputSize);
+
+  try {
+    if (compression == Compression::kGzip) {
+#ifdef NAIVEBAYES_HAVE_ZLIB
+      z_stream stream = z_stream();
+      // Window bits of 15 + 32 accept both gzip and zlib headers.
+      if (inflateInit2(&stream, 15 + 32) != Z_OK) {
+        throw std::invalid_argument("Could not start gzip decompression");
+      }
+
+      int result = Z_OK;
+      bool is_output_full = false;
+      while (true) {
+        if (stream.avail_in == 0 && !is_output_full) {
+          source.read(input.data(), input.size());
+          stream.next_in = reinterpret_cast<Bytef*>(input.data());
+          stream.avail_in = (uInt) source.gcount();
+          if (stream.avail_in == 0) {
+            break;
+          }
+        }
+
+        // A finished member followed by zeros ends the input, as for gzip.
+        if (result == Z_STREAM_END && stream.next_in[0] == 0) {
+          if (!IsZeroPadding(source, reinterpret_cast<char*>(stream.next_in),
+                             stream.avail_in, input)) {
+            inflateEnd(&stream);
+            throw std::invalid_argument("Compressed input is corrupt");
+          }
+          break;
+        }
+
+        Chunk chunk;
+        chunk.data.resize(kChunkSize);
+        stream.next_out = reinterpret_cast<Bytef*>(&chunk.data[0]);
+        stream.avail_out = (uInt) kChunkSize;
+        result = inflate(&stream, Z_NO_FLUSH);
+
+        if (result == Z_STREAM_END) {
+          // Concatenated gzip members decompress one after another.
+          inflateReset(&stream);
+        } else if (result != Z_OK && result != Z_BUF_ERROR) {
+          inflateEnd(&stream);
+          throw std::invalid_argument("Compressed input is corrupt");
+        }
+
+        // A finished member has flushed all of its output.
+        is_output_full = result != Z_STREAM_END && stream.avail_out == 0;
+        chunk.data.resize(kChunkSize - stream.avail_out);
+        if (!chunk.data.empty() && !PushChunk(std::move(chunk))) {
+          inflateEnd(&stream);
+          return;
+        }
+      }
+
+      inflateEnd(&stream);
+      if (result != Z_STREAM_END) {
+        throw std::invalid_argument("Compressed input is truncated");
+      }
+#else
+      throw std::invalid_argument(
+          "gzip input needs a build with NAIVEBAYES_HAVE_ZLIB");
+#endif
+    } else if (compression == Compression::kZstd) {
+#ifdef NAIVEBAYES_HAVE_ZSTD
+      ZSTD_DStream* stream = ZSTD_createDStream();
+      ZSTD_initDStream(stream);
+      ZSTD_inBuffer in = {input.data(), 0, 0};
+
+      size_t result = 0;
+      bool is_output_full = false;
+      while (true) {
+        if (in.pos == in.size && !is_output_full) {
+          source.read(input.data(), input.size());
+          in.size = (size_t) source.gcount();
+          in.pos = 0;
+          if (in.size == 0) {
+            break;
+          }
+        }
+
+        Chunk chunk;
+        chunk.data.resize(kChunkSize);
+        ZSTD_outBuffer out = {&chunk.data[0], kChunkSize, 0};
+        result = ZSTD_decompressStream(stream, &out, &in);
+        if (ZSTD_isError(result)) {
+          ZSTD_freeDStream(stream);
+          throw std::invalid_argument("Compressed input is corrupt");
+        }
+
+        is_output_full = out.pos == kChunkSize;
+        chunk.data.resize(out.pos);
+        if (!chunk.data.empty() && !PushChunk(std::move(chunk))) {
+          ZSTD_freeDStream(stream);
+          return;
+        }
+      }
+
+      ZSTD_freeDStream(stream);
+      // A nonzero result means a frame was not finished.
+      if (result != 0) {
+        throw std::invalid_argument("Compressed input is truncated");
+      }
+#else
+      throw std::invalid_argument(
+          "zstd input needs a build with NAIVEBAYES_HAVE_ZSTD");
+#endif
+    } else {
+      while (source.read(input.data(), input.size()) || source.gcount() > 0) {
+        Chunk chunk;
+        chunk.data.assign(input.data(), (size_t) source.gcount());
+        if (!PushChunk(std::move(chunk))) {
+          return;
+        }
+      }
+    }
+  } catch (const std::exception& error) {
+    last.error = error.what();
+  }
+
+  PushChunk(std::move(last));
+}
+
+InputFile::InputFile(const std::string& file_path)
+    : std::istream(nullptr), file_(file_path, std::ios::binary) {
+  if (file_.fail()) {
+    rdbuf(file_.rdbuf());
+    setstate(std::ios::failbit);
+    return;
+  }
+
+  compression_ = DecompressingStreambuf::DetectCompression(file_);
+  if (compression_ == Compression::kNone) {
+    // Plain files keep the platform's text mode, like std::ifstream.
+    file_.close();
+    file_.open(file_path);
+    rdbuf(file_.rdbuf());
+    return;
+  }
+
+  decompressing_buffer_.reset(
+      new DecompressingStreambuf(file_, compression_));
+  rdbuf(decompressing_buffer_.get());
+  // Lets errors thrown while decompressing reach the caller instead of only
+  // setting badbit.
+  exceptions(std::ios::badbit);
+}
+
+Compression InputFile::GetCompression() const {
+  return compression_;
+}
+
+}  // namespace naivebayes
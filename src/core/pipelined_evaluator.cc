@@ -0,0 +1,126 @@
+#include <core/bounded_queue.h>
+#include <core/pipelined_evaluator.h>
+
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+namespace naivebayes {
+
+PipelinedEvaluator::PipelinedEvaluator(const Classifier& classifier,
+                                       size_t classifier_threads,
+                                       size_t block_size,
+                                       size_t queue_capacity)
+    : classifier_(classifier),
+      classifier_threads_(classifier_threads),
+      block_size_(block_size),
+      queue_capacity_(queue_capacity) {
+  if (classifier_threads_ == 0 || block_size_ == 0 || queue_capacity_ == 0) {
+    throw std::invalid_argument("Pipeline sizes must be greater than zero");
+  }
+}
+
+double PipelinedEvaluator::CalculateAccuracy(std::istream& images_stream,
+                                             std::istream& labels_stream) {
+  return Evaluate(images_stream, labels_stream, 1).GetAccuracy();
+}
+
+EvaluationReport PipelinedEvaluator::Evaluate(std::istream& images_stream,
+                                              std::istream& labels_stream,
+                                              size_t top_k, size_t margin_bins,
+                                              double margin_bin_width) {
+  if (images_stream.fail() || labels_stream.fail()) {
+    throw std::invalid_argument("File does not exist or is blank");
+  }
+
+  const std::vector<size_t>& classes = classifier_.model_.classes_;
+  std::vector<EvaluationReport> reports(
+      classifier_threads_,
+      EvaluationReport(classes, top_k, margin_bins, margin_bin_width));
+  BoundedQueue<ImageBlock> block_queue(queue_capacity_);
+  size_t image_size = classifier_.model_.image_size_;
+  bool has_wrong_size = false;
+
+  // Parsing stage: an empty block tells a classifying thread to stop. Image
+  // sizes are checked here, since classifying an image of the wrong size would
+  // index past the model, and the parser stops at the first one so that no
+  // exception has to leave a thread.
+  std::thread parser([&]() {
+    ImageBlock block;
+    Image image;
+    size_t label;
+
+    while (Images::ReadImage(images_stream, image) && labels_stream >> label) {
+      has_wrong_size = image.size() != image_size;
+      for (const std::vector<char>& row : image) {
+        has_wrong_size = has_wrong_size || row.size() != image_size;
+      }
+      if (has_wrong_size) {
+        break;
+      }
+
+      block.images.push_back(std::move(image));
+      block.labels.push_back(label);
+
+      if (block.images.size() == block_size_) {
+        block_queue.Push(std::move(block));
+        block = ImageBlock();
+      }
+    }
+
+    if (!block.images.empty()) {
+      block_queue.Push(std::move(block));
+    }
+    for (size_t thread = 0; thread < classifier_threads_; thread++) {
+      block_queue.Push(ImageBlock());
+    }
+  });
+
+  // Classifying stages. Scoring every class costs the same as classifying,
+  // which scores every class to find the best one.
+  std::vector<std::thread> classifiers;
+  for (size_t thread = 0; thread < classifier_threads_; thread++) {
+    classifiers.emplace_back([&, thread]() {
+      EvaluationReport& report = reports[thread];
+      std::vector<double> scores(classes.size());
+      ImageBlock block;
+
+      while (true) {
+        block_queue.Pop(block);
+        if (block.images.empty()) {
+          return;
+        }
+
+        for (size_t index = 0; index < block.images.size(); index++) {
+          for (size_t class_index = 0; class_index < classes.size();
+               class_index++) {
+            scores[class_index] = classifier_.CalculateLikelihoodScore(
+                classes[class_index], block.images[index]);
+          }
+          report.AddScores(block.labels[index], scores);
+        }
+      }
+    });
+  }
+
+  parser.join();
+  for (std::thread& thread : classifiers) {
+    thread.join();
+  }
+  if (has_wrong_size) {
+    throw std::invalid_argument(
+        "Image is not the size the model was trained on");
+  }
+
+  for (size_t thread = 1; thread < classifier_threads_; thread++) {
+    reports[0].Merge(reports[thread]);
+  }
+  image_count_ = reports[0].GetImageCount();
+  return reports[0];
+}
+
+size_t PipelinedEvaluator::GetImageCount() const {
+  return image_count_;
+}
+
+}  // namespace naivebayes
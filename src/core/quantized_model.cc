@@ -0,0 +1,208 @@
+#include <core/classifier.h>
+#include <core/quantized_model.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <stdexcept>
+
+namespace naivebayes {
+
+namespace {
+
+// Number of halvings of the maximum scale tried during calibration.
+const size_t kCalibrationSteps = 12;
+
+double LogDelta(const BasicTrainingModel& model, size_t class_num, size_t row,
+                size_t col) {
+  return log10(model.GetPixelProbability(class_num, 1, row, col)) -
+         log10(model.GetPixelProbability(class_num, 0, row, col));
+}
+
+}  // namespace
+
+double QuantizedModel::GetMaxScale(const BasicTrainingModel& model,
+                                   size_t bits) {
+  if (bits != 8 && bits != 16) {
+    throw std::invalid_argument("Quantized models must be 8 or 16 bits");
+  }
+
+  double max_delta = 0;
+  for (size_t class_num : model.classes_) {
+    for (size_t row = 0; row < model.image_size_; row++) {
+      for (size_t col = 0; col < model.image_size_; col++) {
+        max_delta =
+            std::max(max_delta, std::fabs(LogDelta(model, class_num, row, col)));
+      }
+    }
+  }
+
+  double max_value = bits == 8 ? std::numeric_limits<int8_t>::max()
+                               : std::numeric_limits<int16_t>::max();
+  return max_delta == 0 ? max_value : max_value / max_delta;
+}
+
+void QuantizedModel::Quantize(const BasicTrainingModel& model, size_t bits,
+                              double scale) {
+  if (scale <= 0 || scale > GetMaxScale(model, bits)) {
+    throw std::invalid_argument("Scale does not fit in the quantized width");
+  }
+
+  bits_ = bits;
+  scale_ = scale;
+  image_size_ = model.image_size_;
+  classes_ = model.classes_;
+  base_scores_.clear();
+  deltas16_.clear();
+  deltas8_.clear();
+
+  size_t pixel_count = image_size_ * image_size_;
+  for (size_t class_num : classes_) {
+    double base = log10(model.GetClassProbability(class_num));
+    int64_t max_delta_sum = 0;
+
+    for (size_t row = 0; row < image_size_; row++) {
+      for (size_t col = 0; col < image_size_; col++) {
+        base += log10(model.GetPixelProbability(class_num, kUnshaded, row, col));
+
+        long delta = lround(scale * LogDelta(model, class_num, row, col));
+        max_delta_sum += std::abs(delta);
+        if (bits_ == 8) {
+          deltas8_.push_back(static_cast<int8_t>(delta));
+        } else {
+          deltas16_.push_back(static_cast<int16_t>(delta));
+        }
+      }
+    }
+
+    // Scores are accumulated in 32 bits, so the worst case image must not
+    // be able to overflow the accumulator.
+    int64_t scaled_base = llround(scale * base);
+    if (std::llabs(scaled_base) + max_delta_sum >
+        std::numeric_limits<int32_t>::max()) {
+      throw std::invalid_argument("Scale overflows the 32 bit accumulator");
+    }
+    base_scores_.push_back(static_cast<int32_t>(scaled_base));
+  }
+
+  if (pixel_count * classes_.size() != deltas8_.size() + deltas16_.size()) {
+    throw std::invalid_argument("Model is missing pixel probabilities");
+  }
+}
+
+double QuantizedModel::Calibrate(const BasicTrainingModel& model,
+                                 const Images& calibration_images,
+                                 size_t bits) {
+  Classifier classifier;
+  classifier.SetModel(model);
+
+  const std::vector<Image>& images = calibration_images.GetImages();
+  std::vector<size_t> float_predictions;
+  for (const Image& image : images) {
+    float_predictions.push_back(classifier.ClassifyImage(image));
+  }
+
+  double max_scale = GetMaxScale(model, bits);
+  double best_scale = max_scale;
+  size_t best_agreement = 0;
+
+  // Tries scales from coarsest to finest so the first one that agrees on
+  // every calibration image keeps the most accumulator headroom.
+  for (size_t step = kCalibrationSteps + 1; step-- > 0;) {
+    double scale = max_scale / std::pow(2.0, (double) step);
+    Quantize(model, bits, scale);
+
+    size_t agreement = 0;
+    for (size_t index = 0; index < images.size(); index++) {
+      if (ClassifyImage(images[index]) == float_predictions[index]) {
+        agreement++;
+      }
+    }
+
+    if (agreement > best_agreement) {
+      best_agreement = agreement;
+      best_scale = scale;
+    }
+    if (agreement == images.size()) {
+      break;
+    }
+  }
+
+  Quantize(model, bits, best_scale);
+  return best_scale;
+}
+
+template <typename Delta>
+int32_t QuantizedModel::ScoreImage(const Delta* deltas,
+                                   const Image& image) const {
+  int32_t score = 0;
+
+  for (size_t row = 0; row < image_size_; row++) {
+    const std::vector<char>& pixels = image[row];
+    const Delta* row_deltas = deltas + row * image_size_;
+
+    // Branch free so the loop vectorizes: the mask is all ones for shaded
+    // pixels and zero otherwise.
+    for (size_t col = 0; col < image_size_; col++) {
+      int32_t mask = -static_cast<int32_t>(pixels[col] != ' ');
+      score += static_cast<int32_t>(row_deltas[col]) & mask;
+    }
+  }
+  return score;
+}
+
+int32_t QuantizedModel::CalculateLikelihoodScore(const size_t class_index,
+                                                 const Image& image) const {
+  size_t offset = class_index * image_size_ * image_size_;
+
+  if (bits_ == 8) {
+    return base_scores_[class_index] + ScoreImage(&deltas8_[offset], image);
+  }
+  return base_scores_[class_index] + ScoreImage(&deltas16_[offset], image);
+}
+
+size_t QuantizedModel::ClassifyImage(const Image& image) const {
+  size_t predicted_class = 0;
+  int32_t temp = std::numeric_limits<int32_t>::min();
+
+  for (size_t index = 0; index < classes_.size(); index++) {
+    int32_t likelihood_score = CalculateLikelihoodScore(index, image);
+
+    if (temp < likelihood_score) {
+      temp = likelihood_score;
+      predicted_class = classes_[index];
+    }
+  }
+  return predicted_class;
+}
+
+double QuantizedModel::CalculateAccuracy(
+    const Images& images_to_classify,
+    const std::vector<size_t>& expected_classes) const {
+  const std::vector<Image>& images = images_to_classify.GetImages();
+  size_t correct_count = 0;
+
+  for (size_t index = 0; index < expected_classes.size(); index++) {
+    if (ClassifyImage(images[index]) == expected_classes[index]) {
+      correct_count++;
+    }
+  }
+
+  return ((double) correct_count) / (expected_classes.size());
+}
+
+size_t QuantizedModel::GetFootprintBytes() const {
+  return base_scores_.size() * sizeof(int32_t) +
+         deltas16_.size() * sizeof(int16_t) + deltas8_.size() * sizeof(int8_t);
+}
+
+double QuantizedModel::GetScale() const {
+  return scale_;
+}
+
+size_t QuantizedModel::GetBits() const {
+  return bits_;
+}
+
+}  // namespace naivebayes
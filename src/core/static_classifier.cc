@@ -0,0 +1,59 @@
+#include <core/static_classifier.h>
+#include <static_model_tables.h>
+
+#include <cfloat>
+#include <stdexcept>
+
+namespace naivebayes {
+
+using static_model::kImageDimension;
+using static_model::kNumClasses;
+
+double StaticClassifier::CalculateLikelihoodScore(const size_t class_index,
+                                                  const Image& image) {
+  if (image.size() != kImageDimension) {
+    throw std::invalid_argument("Image does not match the compiled model");
+  }
+
+  const double(*pixel_probabilities)[kImageDimension][2] =
+      static_model::kLogPixelProbabilities[class_index];
+  double likelihood_score =
+      static_model::kLogClassProbabilities[class_index];
+
+  for (size_t row = 0; row < kImageDimension; row++) {
+    if (image[row].size() < kImageDimension) {
+      throw std::invalid_argument("Image does not match the compiled model");
+    }
+
+    const char* pixels = image[row].data();
+    for (size_t col = 0; col < kImageDimension; col++) {
+      likelihood_score += pixel_probabilities[row][col][pixels[col] != ' '];
+    }
+  }
+  return likelihood_score;
+}
+
+size_t StaticClassifier::ClassifyImage(const Image& image) {
+  size_t predicted_class = 0;
+  double temp = -DBL_MAX;
+
+  for (size_t index = 0; index < kNumClasses; index++) {
+    double likelihood_score = CalculateLikelihoodScore(index, image);
+
+    if (temp < likelihood_score) {
+      temp = likelihood_score;
+      predicted_class = static_model::kClasses[index];
+    }
+  }
+  return predicted_class;
+}
+
+size_t StaticClassifier::GetImageDimension() {
+  return kImageDimension;
+}
+
+size_t StaticClassifier::GetNumClasses() {
+  return kNumClasses;
+}
+
+}  // namespace naivebayes
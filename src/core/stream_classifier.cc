@@ -0,0 +1,212 @@
+#include <core/stream_classifier.h>
+
+#include <cfloat>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+namespace naivebayes {
+
+StreamClassifier::StreamClassifier(const Classifier& classifier,
+                                   size_t threads, size_t batch_size,
+                                   bool write_scores)
+    : classifier_(classifier),
+      threads_(threads),
+      batch_size_(batch_size),
+      write_scores_(write_scores) {
+  if (threads_ == 0 || batch_size_ == 0) {
+    throw std::invalid_argument("Threads and batch size must be positive");
+  }
+}
+
+size_t StreamClassifier::ClassifyStream(std::istream& is, ImageFormat format,
+                                        std::ostream& os) const {
+  if (is.fail()) {
+    throw std::invalid_argument("File does not exist or is blank");
+  }
+
+  size_t image_size = classifier_.model_.image_size_;
+  if (format == ImageFormat::kPacked &&
+      Images::ReadPackedHeader(is) != image_size) {
+    throw std::invalid_argument(
+        "Packed images are not the size the model was trained on");
+  }
+
+  Workers workers;
+  workers.slices.resize(threads_);
+  std::vector<std::thread> threads;
+  for (size_t thread = 0; thread < threads_; thread++) {
+    threads.emplace_back(&StreamClassifier::RunWorker, this, std::ref(workers),
+                         thread);
+  }
+
+  // Double buffered: the next batch is read while the current one is being
+  // classified.
+  std::vector<Image> current_batch(batch_size_);
+  std::vector<Image> next_batch(batch_size_);
+  size_t image_count = 0;
+  std::exception_ptr error;
+
+  try {
+    size_t current_count = ReadBatch(is, format, image_size, current_batch);
+    while (current_count > 0) {
+      StartBatch(workers, current_batch, current_count);
+      size_t next_count = ReadBatch(is, format, image_size, next_batch);
+
+      std::string lines = FinishBatch(workers);
+      os.write(lines.data(), lines.size());
+      image_count += current_count;
+
+      current_batch.swap(next_batch);
+      current_count = next_count;
+    }
+  } catch (...) {
+    error = std::current_exception();
+  }
+
+  // A batch still being classified when reading failed is finished first, so
+  // the workers never see it destroyed.
+  {
+    std::unique_lock<std::mutex> lock(workers.mutex);
+    workers.batch_done.wait(lock,
+                            [&workers]() { return workers.busy_count == 0; });
+    workers.is_stopping = true;
+  }
+  workers.batch_ready.notify_all();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  os.flush();
+  return image_count;
+}
+
+size_t StreamClassifier::ReadBatch(std::istream& is, ImageFormat format,
+                                   size_t image_size,
+                                   std::vector<Image>& batch) const {
+  size_t count = 0;
+
+  while (count < batch_size_) {
+    Image& image = batch[count];
+    bool was_read = format == ImageFormat::kPacked
+                        ? Images::ReadPackedImage(is, image_size, image)
+                        : Images::ReadImage(is, image);
+    if (!was_read) {
+      break;
+    }
+
+    // Checked here rather than on the worker threads, where classifying an
+    // image of the wrong size would index past the model.
+    if (image.size() != image_size) {
+      throw std::invalid_argument(
+          "Image is not the size the model was trained on");
+    }
+    for (const std::vector<char>& row : image) {
+      if (row.size() != image_size) {
+        throw std::invalid_argument(
+            "Image is not the size the model was trained on");
+      }
+    }
+    count++;
+  }
+  return count;
+}
+
+void StreamClassifier::RunWorker(Workers& workers, size_t thread) const {
+  size_t generation = 0;
+
+  while (true) {
+    const std::vector<Image>* batch;
+    size_t count;
+    {
+      std::unique_lock<std::mutex> lock(workers.mutex);
+      workers.batch_ready.wait(lock, [&workers, generation]() {
+        return workers.is_stopping || workers.generation != generation;
+      });
+      if (workers.is_stopping) {
+        return;
+      }
+      generation = workers.generation;
+      batch = workers.batch;
+      count = workers.count;
+    }
+
+    std::string& slice = workers.slices[thread];
+    slice.clear();
+    for (size_t index = count * thread / threads_;
+         index < count * (thread + 1) / threads_; index++) {
+      WriteLine((*batch)[index], slice);
+    }
+
+    std::lock_guard<std::mutex> lock(workers.mutex);
+    if (--workers.busy_count == 0) {
+      workers.batch_done.notify_one();
+    }
+  }
+}
+
+void StreamClassifier::StartBatch(Workers& workers,
+                                  const std::vector<Image>& batch,
+                                  size_t count) const {
+  {
+    std::lock_guard<std::mutex> lock(workers.mutex);
+    workers.batch = &batch;
+    workers.count = count;
+    workers.generation++;
+    workers.busy_count = threads_;
+  }
+  workers.batch_ready.notify_all();
+}
+
+std::string StreamClassifier::FinishBatch(Workers& workers) const {
+  std::unique_lock<std::mutex> lock(workers.mutex);
+  workers.batch_done.wait(lock,
+                          [&workers]() { return workers.busy_count == 0; });
+
+  std::string output;
+  for (const std::string& slice : workers.slices) {
+    output += slice;
+  }
+  return output;
+}
+
+void StreamClassifier::WriteLine(const Image& image,
+                                 std::string& output) const {
+  char number[32];
+
+  if (!write_scores_) {
+    snprintf(number, sizeof(number), "%zu\n", classifier_.ClassifyImage(image));
+    output += number;
+    return;
+  }
+
+  // Scores every class once and takes the prediction from the same scores.
+  const std::vector<size_t>& classes = classifier_.model_.classes_;
+  std::string scores;
+  size_t predicted_class = 0;
+  double best_score = -DBL_MAX;
+
+  for (size_t class_num : classes) {
+    double likelihood_score =
+        classifier_.CalculateLikelihoodScore(class_num, image);
+    if (best_score < likelihood_score) {
+      best_score = likelihood_score;
+      predicted_class = class_num;
+    }
+
+    snprintf(number, sizeof(number), scores.empty() ? "%.6g" : " %.6g",
+             likelihood_score);
+    scores += number;
+  }
+
+  snprintf(number, sizeof(number), "%zu\t", predicted_class);
+  output += number;
+  output += scores;
+  output += '\n';
+}
+
+}  // namespace naivebayes
@@ -0,0 +1,79 @@
+#include <core/work_stealing_pool.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+namespace naivebayes {
+
+WorkStealingPool::WorkStealingPool(size_t threads) : threads_(threads) {
+  if (threads_ == 0) {
+    throw std::invalid_argument("Pool needs at least one thread");
+  }
+}
+
+void WorkStealingPool::Run(size_t task_count,
+                           const std::function<void(size_t)>& task) {
+  // Deals the tasks out in turn, so each deque starts with a similar mix.
+  std::vector<std::unique_ptr<TaskDeque>> deques;
+  for (size_t thread = 0; thread < threads_; thread++) {
+    deques.emplace_back(new TaskDeque());
+  }
+  for (size_t index = 0; index < task_count; index++) {
+    deques[index % threads_]->tasks.push_back(index);
+  }
+
+  std::atomic<size_t> stolen_count(0);
+  std::vector<std::thread> workers;
+  for (size_t thread = 0; thread < threads_; thread++) {
+    workers.emplace_back([this, &deques, &task, &stolen_count, thread]() {
+      size_t index;
+      bool is_stolen;
+      while (TakeTask(deques, thread, index, is_stolen)) {
+        if (is_stolen) {
+          stolen_count++;
+        }
+        task(index);
+      }
+    });
+  }
+
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  stolen_count_ = stolen_count.load();
+}
+
+size_t WorkStealingPool::GetStolenCount() const {
+  return stolen_count_;
+}
+
+bool WorkStealingPool::TakeTask(
+    std::vector<std::unique_ptr<TaskDeque>>& deques, size_t thread,
+    size_t& task, bool& is_stolen) {
+  {
+    TaskDeque& own = *deques[thread];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = own.tasks.back();
+      own.tasks.pop_back();
+      is_stolen = false;
+      return true;
+    }
+  }
+
+  // No task is ever added during a run, so one empty sweep means done.
+  for (size_t offset = 1; offset < deques.size(); offset++) {
+    TaskDeque& victim = *deques[(thread + offset) % deques.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = victim.tasks.front();
+      victim.tasks.pop_front();
+      is_stolen = true;
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace naivebayes
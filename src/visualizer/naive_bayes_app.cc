@@ -27,7 +27,7 @@ void NaiveBayesApp::draw() {
 }
 
 void NaiveBayesApp::mouseDown(ci::app::MouseEvent event) {
-  sketchpad_.HandleBrush(event.getPos());
+  sketchpad_.StartStroke(event.getPos());
 }
 
 void NaiveBayesApp::mouseDrag(ci::app::MouseEvent event) {
@@ -37,7 +37,12 @@ void NaiveBayesApp::mouseDrag(ci::app::MouseEvent event) {
 void NaiveBayesApp::keyDown(ci::app::KeyEvent event) {
   switch (event.getCode()) {
     case ci::app::KeyEvent::KEY_RETURN:
+#ifdef NAIVEBAYES_STATIC_MODEL
+      current_prediction_ =
+          StaticClassifier::ClassifyImage(sketchpad_.GetDrawingImage());
+#else
       current_prediction_ = classifier.ClassifyImage(sketchpad_.GetDrawingImage());
+#endif
       break;
 
     case ci::app::KeyEvent::KEY_DELETE:
@@ -47,10 +52,14 @@ void NaiveBayesApp::keyDown(ci::app::KeyEvent event) {
   }
 }
 void NaiveBayesApp::TrainClassifier() {
+  // Static-model builds have the model compiled in, so there is nothing to
+  // load.
+#ifndef NAIVEBAYES_STATIC_MODEL
   std::ifstream ifs(
       "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
       "savedmodeldata");
   ifs >> classifier.model_;
+#endif
 }
 
 }  // namespace visualizer
@@ -11,68 +11,111 @@ Sketchpad::Sketchpad(const vec2& top_left_corner, size_t num_pixels_per_side,
     : top_left_corner_(top_left_corner),
       num_pixels_per_side_(num_pixels_per_side),
       pixel_side_length_(sketchpad_size / num_pixels_per_side),
-      brush_radius_(brush_radius) {
-  for (size_t row = 0; row < num_pixels_per_side_; row++) {
-    std::vector<char> temp_row;
-    for (size_t col = 0; col < num_pixels_per_side_; col++) {
-      temp_row.push_back(' ');
-    }
-    sketchpad_image_.push_back(temp_row);
-  }
+      canvas_(num_pixels_per_side, brush_radius) {
 }
 
-void Sketchpad::Draw() const {
-  for (size_t row = 0; row < num_pixels_per_side_; ++row) {
-    for (size_t col = 0; col < num_pixels_per_side_; ++col) {
-      // Currently, this will draw a quarter circle centered at the top-left
-      // corner with a radius of 20
-
-      if (sketchpad_image_[row][col] == kShaded) {
-        ci::gl::color(ci::Color::gray(0.3f));
-      } else {
-        ci::gl::color(ci::Color("white"));
-      }
-
-      vec2 pixel_top_left = top_left_corner_ + vec2(col * pixel_side_length_,
-                                                    row * pixel_side_length_);
-
-      vec2 pixel_bottom_right =
-          pixel_top_left + vec2(pixel_side_length_, pixel_side_length_);
-      ci::Rectf pixel_bounding_box(pixel_top_left, pixel_bottom_right);
+void Sketchpad::Draw() {
+  if (!pixels_batch_) {
+    BuildMeshes();
+  } else if (canvas_.IsDirty()) {
+    UpdateDirtyPixels();
+  }
 
-      ci::gl::drawSolidRect(pixel_bounding_box);
+  pixels_batch_->draw();
+  grid_batch_->draw();
+}
 
-      ci::gl::color(ci::Color("black"));
-      ci::gl::drawStrokedRect(pixel_bounding_box);
-    }
-  }
+void Sketchpad::StartStroke(const vec2& brush_screen_coords) {
+  vec2 brush_sketchpad_coords =
+      (brush_screen_coords - top_left_corner_) / (float)pixel_side_length_;
+  canvas_.StartStroke(brush_sketchpad_coords.x, brush_sketchpad_coords.y);
 }
 
 void Sketchpad::HandleBrush(const vec2& brush_screen_coords) {
   vec2 brush_sketchpad_coords =
       (brush_screen_coords - top_left_corner_) / (float)pixel_side_length_;
+  canvas_.ContinueStroke(brush_sketchpad_coords.x, brush_sketchpad_coords.y);
+}
+
+void Sketchpad::Clear() {
+  canvas_.Clear();
+}
+
+const std::vector<std::vector<char>>& Sketchpad::GetDrawingImage() const {
+  return canvas_.GetImage();
+}
+
+void Sketchpad::BuildMeshes() {
+  ci::TriMesh pixels(ci::TriMesh::Format().positions(2).colors(3));
+  vec2 pixel_width(pixel_side_length_, 0);
+  vec2 pixel_height(0, pixel_side_length_);
 
   for (size_t row = 0; row < num_pixels_per_side_; ++row) {
     for (size_t col = 0; col < num_pixels_per_side_; ++col) {
-      vec2 pixel_center = {col + 0.5, row + 0.5};
-
-      if (glm::distance(brush_sketchpad_coords, pixel_center) <=
-          brush_radius_) {
-        sketchpad_image_[row][col] = kShaded;
+      vec2 pixel_top_left = top_left_corner_ + vec2(col * pixel_side_length_,
+                                                    row * pixel_side_length_);
+      uint32_t first_vertex = (uint32_t) pixels.getNumVertices();
+
+      pixels.appendPosition(pixel_top_left);
+      pixels.appendPosition(pixel_top_left + pixel_width);
+      pixels.appendPosition(pixel_top_left + pixel_width + pixel_height);
+      pixels.appendPosition(pixel_top_left + pixel_height);
+      for (size_t corner = 0; corner < 4; corner++) {
+        pixels.appendColorRgb(GetPixelColor(row, col));
       }
+
+      pixels.appendTriangle(first_vertex, first_vertex + 1, first_vertex + 2);
+      pixels.appendTriangle(first_vertex, first_vertex + 2, first_vertex + 3);
     }
   }
+
+  ci::gl::VertBatch grid(GL_LINES);
+  grid.color(ci::Color("black"));
+  float sketchpad_size = (float) (pixel_side_length_ * num_pixels_per_side_);
+  for (size_t line = 0; line <= num_pixels_per_side_; ++line) {
+    float offset = (float) (line * pixel_side_length_);
+    grid.vertex(top_left_corner_ + vec2(offset, 0));
+    grid.vertex(top_left_corner_ + vec2(offset, sketchpad_size));
+    grid.vertex(top_left_corner_ + vec2(0, offset));
+    grid.vertex(top_left_corner_ + vec2(sketchpad_size, offset));
+  }
+
+  ci::gl::GlslProgRef shader =
+      ci::gl::getStockShader(ci::gl::ShaderDef().color());
+  pixels_mesh_ = ci::gl::VboMesh::create(pixels);
+  pixels_batch_ = ci::gl::Batch::create(pixels_mesh_, shader);
+  grid_batch_ = ci::gl::Batch::create(grid, shader);
+
+  // The mesh was built from the whole canvas.
+  canvas_.ClearDirtyRegion();
 }
 
-void Sketchpad::Clear() {
-  for (size_t row = 0; row < num_pixels_per_side_; row++) {
-    for (size_t col = 0; col < num_pixels_per_side_; col++) {
-      sketchpad_image_[row][col] = kUnshaded;
+void Sketchpad::UpdateDirtyPixels() {
+  const BrushCanvas::Region& region = canvas_.GetDirtyRegion();
+
+  // Maps without orphaning so the colors outside the region are kept.
+  ci::gl::VboMesh::MappedAttrib<glm::vec3> colors =
+      pixels_mesh_->mapAttrib3f(ci::geom::Attrib::COLOR, false);
+  for (size_t row = region.min_row; row <= region.max_row; ++row) {
+    for (size_t col = region.min_col; col <= region.max_col; ++col) {
+      ci::Color color = GetPixelColor(row, col);
+      size_t first_vertex = (row * num_pixels_per_side_ + col) * 4;
+
+      for (size_t corner = 0; corner < 4; corner++) {
+        colors[first_vertex + corner] = glm::vec3(color.r, color.g, color.b);
+      }
     }
   }
+  colors.unmap();
+
+  canvas_.ClearDirtyRegion();
 }
-std::vector<std::vector<char>> Sketchpad::GetDrawingImage() {
-  return sketchpad_image_;
+
+ci::Color Sketchpad::GetPixelColor(size_t row, size_t col) const {
+  if (canvas_.GetImage()[row][col] == ' ') {
+    return ci::Color("white");
+  }
+  return ci::Color::gray(0.3f);
 }
 
 }  // namespace visualizer
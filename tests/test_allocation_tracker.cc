@@ -0,0 +1,56 @@
+#include <core/allocation_tracker.h>
+
+#include <catch2/catch.hpp>
+#include <sstream>
+
+using naivebayes::AllocationTracker;
+
+TEST_CASE("Allocation tracker") {
+  AllocationTracker::ClearStages();
+
+  SECTION("Stages record what happened while they were open") {
+    {
+      AllocationTracker::Stage outer("outer");
+      AllocationTracker::RecordAllocation(100);
+      {
+        AllocationTracker::Stage inner("inner");
+        AllocationTracker::RecordAllocation(50);
+        AllocationTracker::RecordDeallocation(50);
+      }
+      AllocationTracker::RecordDeallocation(100);
+    }
+
+    std::vector<AllocationTracker::StageStats> stages =
+        AllocationTracker::GetStages();
+    REQUIRE(stages.size() == 2);
+
+    // The inner stage closes first.
+    REQUIRE(stages[0].name == "inner");
+    REQUIRE(stages[0].allocations == 1);
+    REQUIRE(stages[0].allocated_bytes == 50);
+    REQUIRE(stages[0].freed_bytes == 50);
+    REQUIRE(stages[0].peak_live_bytes == 50);
+
+    REQUIRE(stages[1].name == "outer");
+    REQUIRE(stages[1].allocations == 2);
+    REQUIRE(stages[1].allocated_bytes == 150);
+    REQUIRE(stages[1].freed_bytes == 150);
+    REQUIRE(stages[1].peak_live_bytes == 150);
+  }
+
+  SECTION("Peak resident memory is reported") {
+    { AllocationTracker::Stage stage("empty"); }
+    REQUIRE(AllocationTracker::GetPeakResidentBytes() > 0);
+    REQUIRE(AllocationTracker::GetStages()[0].peak_resident_bytes > 0);
+  }
+
+  SECTION("Report lists every stage") {
+    { AllocationTracker::Stage stage("parse"); }
+    { AllocationTracker::Stage stage("train"); }
+
+    std::stringstream report;
+    AllocationTracker::WriteReport(report);
+    REQUIRE(report.str().find("parse") != std::string::npos);
+    REQUIRE(report.str().find("train") != std::string::npos);
+  }
+}
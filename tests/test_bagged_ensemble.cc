@@ -0,0 +1,91 @@
+#include <core/bagged_ensemble.h>
+#include <core/basic_training_model.h>
+#include <core/classifier.h>
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <sstream>
+
+using naivebayes::BaggedEnsemble;
+using naivebayes::BasicTrainingModel;
+using naivebayes::Classifier;
+using naivebayes::Images;
+
+TEST_CASE("Bagged ensemble") {
+  BasicTrainingModel model;
+  Images training_images;
+  std::ifstream ifs1(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "trainingimages");
+  ifs1 >> training_images;
+  model.ReadLabels(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "traininglabels");
+
+  Classifier classifier;
+  classifier.ReadLabels(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "testlabels");
+  Images test_images;
+  std::ifstream ifs2(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "testimages");
+  ifs2 >> test_images;
+
+  BaggedEnsemble ensemble;
+  ensemble.TrainModels(training_images, model.GetLabels(), 5, 42);
+
+  SECTION("Every replica votes once") {
+    std::vector<size_t> votes;
+    std::vector<double> scores;
+    ensemble.CalculateVotes(test_images.GetImage(0), votes, scores);
+
+    size_t vote_count = 0;
+    for (size_t vote : votes) {
+      vote_count += vote;
+    }
+    REQUIRE(votes.size() == ensemble.GetClasses().size());
+    REQUIRE(vote_count == ensemble.GetReplicaCount());
+  }
+
+  SECTION("Training is reproducible") {
+    BaggedEnsemble same_seed;
+    same_seed.TrainModels(training_images, model.GetLabels(), 5, 42);
+    for (size_t index = 0; index < 50; index++) {
+      REQUIRE(same_seed.ClassifyImage(test_images.GetImage(index)) ==
+              ensemble.ClassifyImage(test_images.GetImage(index)));
+    }
+  }
+
+  SECTION("Accuracy is acceptable") {
+    REQUIRE(ensemble.CalculateAccuracy(
+                test_images, classifier.GetExpectedClasses()) > .7);
+  }
+
+  SECTION("Labels must match the images") {
+    std::vector<size_t> too_few_labels(3, 0);
+    REQUIRE_THROWS_AS(ensemble.TrainModels(training_images, too_few_labels, 5, 42),
+                      std::invalid_argument);
+  }
+
+  SECTION("Images must match the training size") {
+    naivebayes::Image narrow_rows = test_images.GetImage(0);
+    narrow_rows[27].pop_back();
+    std::vector<size_t> votes;
+    std::vector<double> scores;
+    REQUIRE_THROWS_AS(ensemble.CalculateVotes(narrow_rows, votes, scores),
+                      std::invalid_argument);
+
+    naivebayes::Image small_image(3, std::vector<char>(3, '#'));
+    REQUIRE_THROWS_AS(ensemble.ClassifyImage(small_image),
+                      std::invalid_argument);
+
+    std::stringstream mixed_sizes;
+    mixed_sizes << "    \n    \n    \n    \n  \n  \n";
+    Images mixed_images;
+    mixed_sizes >> mixed_images;
+    REQUIRE_THROWS_AS(ensemble.TrainModels(mixed_images, {1, 2}, 5, 42),
+                      std::invalid_argument);
+    REQUIRE(ensemble.GetReplicaCount() == 5);
+  }
+}
@@ -95,6 +95,28 @@ TEST_CASE("Calculating probabilities") {
   }
 }
 
+TEST_CASE("Smoothing value") {
+  BasicTrainingModel model;
+  Images test_data;
+  std::ifstream ifs(test_images_file_path);
+  ifs >> test_data;
+  model.SetImages(test_data);
+  model.ReadLabels(test_labels_file_path);
+
+  SECTION("Smaller smoothing moves priors toward the class frequencies") {
+    model.SetSmoothing(0.5);
+    model.TrainModel();
+    std::vector<double> actual_values = model.GetProbabilities();
+    REQUIRE(actual_values[0] == Approx(0.375));
+    REQUIRE(actual_values[1] == Approx(0.625));
+  }
+
+  SECTION("Smoothing must be positive") {
+    REQUIRE_THROWS_AS(model.SetSmoothing(0), std::invalid_argument);
+    REQUIRE_THROWS_AS(model.SetSmoothing(-1), std::invalid_argument);
+  }
+}
+
 TEST_CASE("Reading in files") {
   Image image1 = {{'#', '#', '#'}, {'#', ' ', '#'}, {'#', '#', '#'}};
   Image image2 = {{'#', '#', ' '}, {' ', '#', ' '}, {'#', '#', '#'}};
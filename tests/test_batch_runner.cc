@@ -0,0 +1,252 @@
+#include <core/basic_training_model.h>
+#include <core/batch_runner.h>
+#include <core/classifier.h>
+#include <core/count_snapshot.h>
+#include <core/work_stealing_pool.h>
+
+#include <atomic>
+#include <chrono>
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+using naivebayes::BasicTrainingModel;
+using naivebayes::BatchJob;
+using naivebayes::BatchResult;
+using naivebayes::BatchRunner;
+using naivebayes::Classifier;
+using naivebayes::CountSnapshot;
+using naivebayes::Images;
+using naivebayes::WorkStealingPool;
+
+std::string batch_training_images_file_path =
+    "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+    "trainingimages";
+std::string batch_training_labels_file_path =
+    "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+    "traininglabels";
+std::string batch_test_images_file_path =
+    "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+    "testimages";
+std::string batch_test_labels_file_path =
+    "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+    "testlabels";
+
+TEST_CASE("Work stealing pool") {
+  SECTION("Runs every task exactly once") {
+    const size_t kCount = 1000;
+    std::vector<std::atomic<size_t>> calls(kCount);
+    for (std::atomic<size_t>& count : calls) {
+      count = 0;
+    }
+
+    WorkStealingPool pool(4);
+    pool.Run(kCount, [&calls](size_t index) { calls[index]++; });
+    for (const std::atomic<size_t>& count : calls) {
+      REQUIRE(count.load() == 1);
+    }
+  }
+
+  SECTION("Idle threads steal from a thread with long tasks") {
+    WorkStealingPool pool(2);
+    // Every even task lands on the first thread and takes much longer.
+    std::atomic<size_t> total(0);
+    pool.Run(20, [&total](size_t index) {
+      if (index % 2 == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      }
+      total += index;
+    });
+    REQUIRE(total.load() == 190);
+    REQUIRE(pool.GetStolenCount() > 0);
+  }
+
+  SECTION("No tasks") {
+    WorkStealingPool pool(3);
+    std::atomic<size_t> calls(0);
+    pool.Run(0, [&calls](size_t) { calls++; });
+    REQUIRE(calls.load() == 0);
+    REQUIRE(pool.GetStolenCount() == 0);
+  }
+
+  SECTION("No threads") {
+    REQUIRE_THROWS_AS(WorkStealingPool(0), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Reading a batch manifest") {
+  SECTION("Options, defaults and comments") {
+    std::stringstream manifest(
+        "# sweep of smoothing values\n"
+        "baseline\n"
+        "\n"
+        "smooth smoothing=0.1 downsample=2  # pooled\n"
+        "center rows=4:24 cols=6:22 holdout=0.2\n");
+    std::vector<BatchJob> jobs = BatchRunner::ReadManifest(manifest);
+    REQUIRE(jobs.size() == 3);
+
+    REQUIRE(jobs[0].name == "baseline");
+    REQUIRE(jobs[0].smoothing == 1);
+    REQUIRE(jobs[0].downsample == 1);
+    REQUIRE(jobs[0].holdout == 0);
+
+    REQUIRE(jobs[1].name == "smooth");
+    REQUIRE(jobs[1].smoothing == Approx(0.1));
+    REQUIRE(jobs[1].downsample == 2);
+
+    REQUIRE(jobs[2].first_row == 4);
+    REQUIRE(jobs[2].end_row == 24);
+    REQUIRE(jobs[2].first_col == 6);
+    REQUIRE(jobs[2].end_col == 22);
+    REQUIRE(jobs[2].holdout == Approx(0.2));
+  }
+
+  SECTION("Unknown option") {
+    std::stringstream manifest("job colour=red\n");
+    REQUIRE_THROWS_AS(BatchRunner::ReadManifest(manifest),
+                      std::invalid_argument);
+  }
+
+  SECTION("Range without a colon") {
+    std::stringstream manifest("job rows=4\n");
+    REQUIRE_THROWS_AS(BatchRunner::ReadManifest(manifest),
+                      std::invalid_argument);
+  }
+
+  SECTION("Malformed values name their line and option") {
+    std::vector<std::string> bad_lines = {
+        "neg downsample=-1", "bare smoothing", "junk downsample=2x",
+        "huge downsample=99999999999999999999", "signed rows=+1:4",
+        "empty holdout="};
+    for (const std::string& bad_line : bad_lines) {
+      std::stringstream manifest("good\n\n" + bad_line + "\n");
+      try {
+        BatchRunner::ReadManifest(manifest);
+        FAIL("Accepted " + bad_line);
+      } catch (const std::invalid_argument& error) {
+        std::string option = bad_line.substr(bad_line.find(' ') + 1);
+        REQUIRE(std::string(error.what()).find("line 3, option " + option) !=
+                std::string::npos);
+      }
+    }
+  }
+
+  SECTION("Missing file") {
+    std::ifstream manifest("fes/dw.txt");
+    REQUIRE_THROWS_AS(BatchRunner::ReadManifest(manifest),
+                      std::invalid_argument);
+  }
+}
+
+TEST_CASE("Running a job on test images of another size") {
+  std::stringstream training_file(
+      "#   \n #  \n  # \n   #\n"
+      "    \n    \n    \n    \n");
+  Images training_images;
+  training_file >> training_images;
+  std::stringstream test_file("# \n #\n");
+  Images test_images;
+  test_file >> test_images;
+
+  // The runner keeps references, so the labels must outlive it.
+  std::vector<size_t> training_labels = {1, 2};
+  std::vector<size_t> test_labels = {1};
+  BatchRunner runner(training_images, training_labels, test_images,
+                     test_labels, 1);
+  BatchJob job;
+  REQUIRE_THROWS_AS(runner.RunJob(job), std::invalid_argument);
+
+  std::vector<BatchResult> results = runner.Run({job});
+  REQUIRE(results[0].error ==
+          "Evaluation images are not the size of the training images");
+}
+
+TEST_CASE("Running a batch of jobs") {
+  Images training_images;
+  std::ifstream ifs1(batch_training_images_file_path);
+  ifs1 >> training_images;
+  BasicTrainingModel labels_model;
+  labels_model.ReadLabels(batch_training_labels_file_path);
+  const std::vector<size_t>& training_labels = labels_model.GetLabels();
+
+  Images test_images;
+  std::ifstream ifs2(batch_test_images_file_path);
+  ifs2 >> test_images;
+  Classifier classifier;
+  classifier.ReadLabels(batch_test_labels_file_path);
+  const std::vector<size_t>& test_labels = classifier.GetExpectedClasses();
+
+  BatchRunner runner(training_images, training_labels, test_images,
+                     test_labels, 2);
+
+  SECTION("A default job matches the classifier's accuracy") {
+    CountSnapshot counts;
+    counts.AddImages(training_images, training_labels, 0,
+                     training_labels.size());
+    classifier.model_.TrainModel(counts);
+    double expected_accuracy = classifier.CalculateAccuracy(test_images);
+
+    BatchJob job;
+    job.name = "baseline";
+    BatchResult result = runner.RunJob(job);
+    REQUIRE(result.error.empty());
+    REQUIRE(result.training_count == training_labels.size());
+    REQUIRE(result.evaluation_count == test_images.Size());
+    REQUIRE(result.accuracy == Approx(expected_accuracy));
+    REQUIRE(result.top_3_accuracy >= result.accuracy);
+  }
+
+  SECTION("A holdout evaluates on the end of the training images") {
+    BatchJob job;
+    job.holdout = 0.25;
+    BatchResult result = runner.RunJob(job);
+    size_t held_out = training_labels.size() / 4;
+    REQUIRE(result.training_count == training_labels.size() - held_out);
+    REQUIRE(result.evaluation_count == held_out);
+  }
+
+  SECTION("Results keep job order and failed jobs do not stop others") {
+    std::stringstream manifest(
+        "full\n"
+        "pooled downsample=2\n"
+        "empty rows=10:10\n"
+        "window rows=4:24 cols=4:24 smoothing=0.5\n");
+    std::vector<BatchResult> results =
+        runner.Run(BatchRunner::ReadManifest(manifest));
+    REQUIRE(results.size() == 4);
+
+    REQUIRE(results[0].job.name == "full");
+    REQUIRE(results[1].job.name == "pooled");
+    REQUIRE(results[3].job.name == "window");
+    REQUIRE(results[0].error.empty());
+    REQUIRE(results[1].error.empty());
+    REQUIRE(results[3].error.empty());
+    REQUIRE(results[2].error == "Feature window holds no pixels");
+    REQUIRE(results[1].accuracy > 0.5);
+    REQUIRE(results[3].accuracy > 0.5);
+
+    std::stringstream report;
+    BatchRunner::WriteReport(report, results);
+    REQUIRE(report.str().find("failed: Feature window") != std::string::npos);
+  }
+
+  SECTION("Options out of range") {
+    BatchJob job;
+    job.smoothing = 0;
+    REQUIRE_THROWS_AS(runner.RunJob(job), std::invalid_argument);
+    job.smoothing = 1;
+    job.holdout = 1;
+    REQUIRE_THROWS_AS(runner.RunJob(job), std::invalid_argument);
+    job.holdout = 0;
+    job.downsample = 29;
+    REQUIRE_THROWS_AS(runner.RunJob(job), std::invalid_argument);
+  }
+
+  SECTION("Downsampling to a single pixel") {
+    BatchJob job;
+    job.downsample = 28;
+    BatchResult result = runner.RunJob(job);
+    REQUIRE(result.evaluation_count == test_images.Size());
+  }
+}
@@ -0,0 +1,84 @@
+#include <core/brush_canvas.h>
+
+#include <catch2/catch.hpp>
+#include <cmath>
+
+using naivebayes::BrushCanvas;
+using naivebayes::Image;
+
+/**
+ * Shades every pixel within radius of the point by checking the whole image.
+ */
+Image StampEveryPixel(size_t size, double x, double y, double radius) {
+  Image image(size, std::vector<char>(size, ' '));
+  for (size_t row = 0; row < size; row++) {
+    for (size_t col = 0; col < size; col++) {
+      if (std::hypot(col + .5 - x, row + .5 - y) <= radius) {
+        image[row][col] = '#';
+      }
+    }
+  }
+  return image;
+}
+
+TEST_CASE("Brush canvas") {
+  BrushCanvas canvas(28);
+
+  SECTION("Stamps match checking every pixel") {
+    double points[][2] = {{14, 14}, {0, 0}, {27.9, 3.2}, {-1, 5}, {10.5, 10.5}};
+    for (const double* point : points) {
+      BrushCanvas stamped(28);
+      stamped.StartStroke(point[0], point[1]);
+      REQUIRE(stamped.GetImage() ==
+              StampEveryPixel(28, point[0], point[1], 1.15));
+    }
+  }
+
+  SECTION("Stamps only visit the brush's bounding box") {
+    canvas.StartStroke(14, 14);
+    REQUIRE(canvas.GetVisitedPixelCount() <= 9);
+  }
+
+  SECTION("Fast drags leave no gaps") {
+    canvas.StartStroke(2.5, 5.5);
+    canvas.ContinueStroke(25.5, 5.5);
+    for (size_t col = 2; col <= 25; col++) {
+      REQUIRE(canvas.GetImage()[5][col] == '#');
+    }
+    REQUIRE(canvas.GetImage()[8][10] == ' ');
+  }
+
+  SECTION("A new stroke does not connect to the last one") {
+    canvas.StartStroke(2.5, 5.5);
+    canvas.StartStroke(25.5, 5.5);
+    REQUIRE(canvas.GetImage()[5][14] == ' ');
+  }
+
+  SECTION("Dirty region covers the changed pixels") {
+    REQUIRE_FALSE(canvas.IsDirty());
+    canvas.StartStroke(10.5, 20.5);
+    canvas.ContinueStroke(12.5, 20.5);
+
+    REQUIRE(canvas.IsDirty());
+    BrushCanvas::Region region = canvas.GetDirtyRegion();
+    REQUIRE(region.min_row == 19);
+    REQUIRE(region.max_row == 21);
+    REQUIRE(region.min_col == 9);
+    REQUIRE(region.max_col == 13);
+
+    // Shading already shaded pixels changes nothing.
+    canvas.ClearDirtyRegion();
+    canvas.ContinueStroke(10.5, 20.5);
+    REQUIRE_FALSE(canvas.IsDirty());
+  }
+
+  SECTION("Clear unshades everything") {
+    canvas.StartStroke(14, 14);
+    canvas.ClearDirtyRegion();
+    canvas.Clear();
+
+    REQUIRE(canvas.GetImage() == Image(28, std::vector<char>(28, ' ')));
+    REQUIRE(canvas.IsDirty());
+    REQUIRE(canvas.GetDirtyRegion().max_row == 27);
+  }
+}
@@ -0,0 +1,77 @@
+#include <core/basic_training_model.h>
+#include <core/cascade_classifier.h>
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <limits>
+
+using naivebayes::BasicTrainingModel;
+using naivebayes::CascadeClassifier;
+using naivebayes::Classifier;
+using naivebayes::Image;
+using naivebayes::Images;
+
+TEST_CASE("Downsampling images") {
+  Image image = {{'#', ' ', ' '}, {' ', ' ', ' '}, {' ', ' ', '+'}};
+  Image pooled;
+
+  SECTION("Factor that does not divide the size") {
+    Images::Downsample(image, 2, pooled);
+    Image expected = {{'#', ' '}, {' ', '#'}};
+    REQUIRE(pooled == expected);
+  }
+
+  SECTION("Factor of one keeps every pixel's shade") {
+    Images::Downsample(image, 1, pooled);
+    Image expected = {{'#', ' ', ' '}, {' ', ' ', ' '}, {' ', ' ', '#'}};
+    REQUIRE(pooled == expected);
+  }
+
+  SECTION("Factor larger than the image pools it into one pixel") {
+    Images::Downsample(image, std::numeric_limits<size_t>::max(), pooled);
+    Image expected = {{'#'}};
+    REQUIRE(pooled == expected);
+  }
+}
+
+TEST_CASE("Cascade classifier") {
+  Images training_images;
+  std::ifstream ifs1(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "trainingimages");
+  ifs1 >> training_images;
+  BasicTrainingModel model;
+  model.ReadLabels(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "traininglabels");
+
+  Images test_images;
+  std::ifstream ifs2(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "testimages");
+  ifs2 >> test_images;
+
+  CascadeClassifier cascade;
+  cascade.TrainModels(training_images, model.GetLabels(), {4, 2});
+
+  Classifier classifier = cascade.GetFullClassifier();
+  classifier.ReadLabels(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "testlabels");
+  double full_accuracy = classifier.CalculateAccuracy(test_images);
+
+  SECTION("Untuned cascade always falls back") {
+    REQUIRE(cascade.CalculateAccuracy(test_images,
+                                      classifier.GetExpectedClasses()) ==
+            Approx(full_accuracy));
+    REQUIRE(cascade.GetEarlyFraction() == 0);
+  }
+
+  SECTION("Tuned cascade resolves images early") {
+    cascade.TuneThresholds(training_images, .99);
+    REQUIRE(cascade.CalculateAccuracy(test_images,
+                                      classifier.GetExpectedClasses()) ==
+            Approx(full_accuracy).margin(.02));
+    REQUIRE(cascade.GetEarlyFraction() > 0);
+  }
+}
@@ -0,0 +1,92 @@
+#include <core/classification_cache.h>
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <thread>
+
+using naivebayes::ClassificationCache;
+using naivebayes::Classifier;
+using naivebayes::Image;
+using naivebayes::Images;
+
+TEST_CASE("Classification cache") {
+  Classifier classifier;
+  std::ifstream ifs1(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "savedmodeldata");
+  ifs1 >> classifier.model_;
+
+  Images test_images;
+  std::ifstream ifs2(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "testimages");
+  ifs2 >> test_images;
+  const Image& image = test_images.GetImage(0);
+
+  SECTION("Repeated images hit") {
+    ClassificationCache cache(classifier, 10);
+    REQUIRE(cache.ClassifyImage(image) == classifier.ClassifyImage(image));
+    REQUIRE(cache.ClassifyImage(image) == classifier.ClassifyImage(image));
+    REQUIRE(cache.GetMisses() == 1);
+    REQUIRE(cache.GetHits() == 1);
+  }
+
+  SECTION("Changing the model version misses") {
+    ClassificationCache cache(classifier, 10);
+    cache.ClassifyImage(image);
+    cache.SetModelVersion(1);
+    cache.ClassifyImage(image);
+    REQUIRE(cache.GetMisses() == 2);
+    REQUIRE(cache.GetHits() == 0);
+  }
+
+  SECTION("Images with rows too wide to pack are not cached") {
+    ClassificationCache cache(classifier, 10);
+    Image wide_image = image;
+    wide_image[0].resize(65, '#');
+    REQUIRE(cache.ClassifyImage(wide_image) ==
+            classifier.ClassifyImage(wide_image));
+    cache.ClassifyImage(wide_image);
+    REQUIRE(cache.GetMisses() == 2);
+    REQUIRE(cache.Size() == 0);
+  }
+
+  SECTION("Least recently used images are evicted") {
+    ClassificationCache cache(classifier, 2, 1);
+    cache.ClassifyImage(test_images.GetImage(0));
+    cache.ClassifyImage(test_images.GetImage(1));
+    cache.ClassifyImage(test_images.GetImage(0));
+    cache.ClassifyImage(test_images.GetImage(2));
+    REQUIRE(cache.Size() == 2);
+
+    // Image 1 was least recently used, so it was the one evicted.
+    cache.ClassifyImage(test_images.GetImage(0));
+    REQUIRE(cache.GetHits() == 2);
+    cache.ClassifyImage(test_images.GetImage(1));
+    REQUIRE(cache.GetMisses() == 4);
+  }
+
+  SECTION("Threads share the cache") {
+    ClassificationCache cache(classifier, 100);
+    // Catch's assertions are not thread safe, so workers only count.
+    std::atomic<size_t> mismatches(0);
+    std::vector<std::thread> threads;
+    for (size_t thread = 0; thread < 4; thread++) {
+      threads.emplace_back([&]() {
+        for (size_t index = 0; index < 50; index++) {
+          if (cache.ClassifyImage(test_images.GetImage(index)) !=
+              classifier.ClassifyImage(test_images.GetImage(index))) {
+            mismatches++;
+          }
+        }
+      });
+    }
+    for (std::thread& thread : threads) {
+      thread.join();
+    }
+    REQUIRE(mismatches.load() == 0);
+    REQUIRE(cache.GetHits() + cache.GetMisses() == 200);
+    REQUIRE(cache.Size() <= 100);
+  }
+}
@@ -1,7 +1,10 @@
 #include <core/classifier.h>
 
+#include <atomic>
 #include <catch2/catch.hpp>
+#include <cstdlib>
 #include <fstream>
+#include <new>
 
 using naivebayes::BasicTrainingModel;
 using naivebayes::Classifier;
@@ -77,3 +80,64 @@ TEST_CASE("Accuracy is acceptable") {
 
   REQUIRE(classifier.CalculateAccuracy(test_images) > .7);
 }
+
+namespace {
+// Counts calls to the global operator new made while is_counting is set.
+// Other tests in this binary allocate from their own threads, so both are
+// atomic.
+std::atomic<bool> is_counting(false);
+std::atomic<size_t> allocation_count(0);
+}  // namespace
+
+void* operator new(std::size_t size) {
+  if (is_counting.load(std::memory_order_relaxed)) {
+    allocation_count++;
+  }
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+  // Going through a volatile keeps GCC from pairing this inlined free with
+  // the out-of-line operator new above and warning about a mismatch.
+  void* volatile block = pointer;
+  std::free(block);
+}
+
+TEST_CASE("Classifying does not allocate") {
+  Classifier classifier;
+  std::ifstream ifs1(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "savedmodeldata");
+  ifs1 >> classifier.model_;
+
+  // Reading the labels allocates, which shows the counting operator new is
+  // live.
+  allocation_count = 0;
+  is_counting = true;
+  classifier.ReadLabels(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "testlabels");
+  is_counting = false;
+  size_t loading_allocations = allocation_count;
+
+  Images test_images;
+  std::ifstream ifs2(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "testimages");
+  ifs2 >> test_images;
+
+  allocation_count = 0;
+  is_counting = true;
+  size_t predicted_class = classifier.ClassifyImage(test_images.GetImage(0));
+  double accuracy = classifier.CalculateAccuracy(test_images);
+  is_counting = false;
+  size_t classifying_allocations = allocation_count;
+
+  REQUIRE(predicted_class < classifier.model_.num_classes_);
+  REQUIRE(accuracy > .7);
+  REQUIRE(loading_allocations > 0);
+  REQUIRE(classifying_allocations == 0);
+}
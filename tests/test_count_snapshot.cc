@@ -0,0 +1,164 @@
+#include <core/basic_training_model.h>
+#include <core/count_snapshot.h>
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <sstream>
+
+using naivebayes::BasicTrainingModel;
+using naivebayes::CountSnapshot;
+using naivebayes::Images;
+
+TEST_CASE("Merging count snapshots of shards") {
+  Images training_images;
+  std::ifstream ifs(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "trainingimages");
+  ifs >> training_images;
+
+  BasicTrainingModel full_model;
+  full_model.SetImages(training_images);
+  full_model.ReadLabels(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "traininglabels");
+  full_model.TrainModel();
+  const std::vector<size_t>& labels = full_model.GetLabels();
+
+  // Splits the training data into uneven shards and round trips each
+  // snapshot through the file format.
+  std::vector<size_t> shard_ends = {1000, 1700, 4000, labels.size()};
+  std::vector<CountSnapshot> shards;
+  size_t begin = 0;
+  for (size_t end : shard_ends) {
+    CountSnapshot counts;
+    counts.AddImages(training_images, labels, begin, end);
+
+    std::stringstream file;
+    file << counts;
+    CountSnapshot read_counts;
+    file >> read_counts;
+    shards.push_back(read_counts);
+    begin = end;
+  }
+
+  SECTION("Merged model matches the model trained on every image") {
+    CountSnapshot merged;
+    for (const CountSnapshot& shard : shards) {
+      merged.Merge(shard);
+    }
+    REQUIRE(merged.GetImageCount() == labels.size());
+
+    BasicTrainingModel merged_model;
+    merged_model.TrainModel(merged);
+    REQUIRE(merged_model.num_classes_ == full_model.num_classes_);
+
+    std::vector<double> expected = full_model.GetProbabilities();
+    std::vector<double> actual = merged_model.GetProbabilities();
+    REQUIRE(actual.size() == expected.size());
+    for (size_t index = 0; index < expected.size(); index++) {
+      REQUIRE(actual[index] == Approx(expected[index]));
+    }
+  }
+
+  SECTION("Merging is associative") {
+    CountSnapshot left;
+    left.Merge(shards[0]);
+    left.Merge(shards[1]);
+    CountSnapshot right;
+    right.Merge(shards[2]);
+    right.Merge(shards[3]);
+    left.Merge(right);
+
+    CountSnapshot reversed;
+    for (size_t index = shards.size(); index-- > 0;) {
+      reversed.Merge(shards[index]);
+    }
+
+    std::stringstream left_file;
+    left_file << left;
+    std::stringstream reversed_file;
+    reversed_file << reversed;
+    REQUIRE(left_file.str() == reversed_file.str());
+  }
+
+  SECTION("Snapshots of different image sizes") {
+    CountSnapshot small;
+    small.AddImage({{' ', '#'}, {'#', ' '}}, 0);
+    REQUIRE_THROWS_AS(small.Merge(shards[0]), std::invalid_argument);
+  }
+
+  SECTION("Images with rows of the wrong width") {
+    CountSnapshot counts;
+    REQUIRE_THROWS_AS(counts.AddImage({{' ', '#'}, {'#'}}, 0),
+                      std::invalid_argument);
+    REQUIRE(counts.GetImageCount() == 0);
+
+    counts.AddImage({{' ', '#'}, {'#', ' '}}, 0);
+    REQUIRE_THROWS_AS(counts.AddImage({{' ', '#', ' '}, {'#', ' '}}, 0),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(counts.AddImage({{' ', '#'}, {'#', ' ', ' '}}, 0,
+                                      {naivebayes::ImageShift{0, 0}}),
+                      std::invalid_argument);
+    REQUIRE(counts.GetImageCount() == 1);
+  }
+}
+
+TEST_CASE("Counting shifted images") {
+  naivebayes::Image image = {{'#', ' ', ' '}, {' ', '#', ' '}, {' ', ' ', ' '}};
+
+  SECTION("No shift counts the image itself") {
+    CountSnapshot plain;
+    plain.AddImage(image, 4);
+    CountSnapshot shifted;
+    shifted.AddImage(image, 4, {{0, 0}});
+
+    std::stringstream expected;
+    std::stringstream actual;
+    expected << plain;
+    actual << shifted;
+    REQUIRE(actual.str() == expected.str());
+  }
+
+  SECTION("Shifts move pixels and unshade the uncovered edge") {
+    CountSnapshot counts;
+    counts.AddImage(image, 4, {{1, 1}});
+    naivebayes::Image expected = {
+        {' ', ' ', ' '}, {' ', '#', ' '}, {' ', ' ', '#'}};
+
+    for (size_t row = 0; row < 3; row++) {
+      for (size_t col = 0; col < 3; col++) {
+        REQUIRE(counts.GetUnshadedCount(4, row, col) ==
+                (expected[row][col] == ' ' ? 1 : 0));
+      }
+    }
+  }
+
+  SECTION("Shifts past the edge leave a blank image") {
+    CountSnapshot counts;
+    counts.AddImage(image, 4, {{-1, 0}, {0, -5}, {0, 70}});
+    REQUIRE(counts.GetUnshadedCount(4, 0, 0) == 3);
+    REQUIRE(counts.GetUnshadedCount(4, 0, 1) == 2);
+  }
+
+  SECTION("Every shift counts as an image") {
+    std::vector<naivebayes::ImageShift> shifts = CountSnapshot::MakeShifts(1);
+    REQUIRE(shifts.size() == 9);
+
+    CountSnapshot counts;
+    counts.AddImage(image, 4, shifts);
+    counts.AddImage(image, 7, shifts);
+    REQUIRE(counts.GetImageCount() == 18);
+    REQUIRE(counts.GetClassSize(4) == 9);
+    // The center pixel is shaded by the copies shifted by (0, 0) and
+    // (1, 1).
+    REQUIRE(counts.GetUnshadedCount(4, 1, 1) == 7);
+  }
+
+  SECTION("No shifts add no class") {
+    CountSnapshot counts;
+    counts.AddImage(image, 4, {{0, 0}});
+    counts.AddImage(image, 7, {});
+    REQUIRE(counts.GetImageCount() == 1);
+    REQUIRE(counts.GetClasses() == std::vector<size_t>{4});
+  }
+}
@@ -0,0 +1,75 @@
+#include <core/dataset_generator.h>
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <sstream>
+
+using naivebayes::BasicTrainingModel;
+using naivebayes::DatasetGenerator;
+using naivebayes::Image;
+using naivebayes::ImageFormat;
+using naivebayes::Images;
+
+TEST_CASE("Generating synthetic datasets") {
+  BasicTrainingModel model;
+  std::ifstream ifs(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "savedmodeldata");
+  ifs >> model;
+
+  // Spans several chunks, the last of them partial.
+  size_t image_count = DatasetGenerator::kChunkSize * 2 + 10;
+
+  std::stringstream images1;
+  std::stringstream labels1;
+  DatasetGenerator(model, 7, 1).Generate(image_count, ImageFormat::kAscii,
+                                         images1, labels1);
+
+  SECTION("Output does not depend on the thread count") {
+    std::stringstream images2;
+    std::stringstream labels2;
+    DatasetGenerator(model, 7, 3).Generate(image_count, ImageFormat::kAscii,
+                                           images2, labels2);
+    REQUIRE(images1.str() == images2.str());
+    REQUIRE(labels1.str() == labels2.str());
+  }
+
+  SECTION("Different seeds give different images") {
+    std::stringstream images2;
+    std::stringstream labels2;
+    DatasetGenerator(model, 8, 1).Generate(image_count, ImageFormat::kAscii,
+                                           images2, labels2);
+    REQUIRE(images1.str() != images2.str());
+  }
+
+  SECTION("Ascii output can be read back") {
+    Images generated;
+    images1 >> generated;
+    REQUIRE(generated.Size() == image_count);
+    REQUIRE(generated.GetImage(0).size() == model.image_size_);
+
+    size_t label_count = 0;
+    size_t label;
+    while (labels1 >> label) {
+      label_count++;
+    }
+    REQUIRE(label_count == image_count);
+  }
+
+  SECTION("Packed output holds the same images") {
+    std::stringstream packed;
+    std::stringstream labels2;
+    DatasetGenerator(model, 7, 2).Generate(image_count, ImageFormat::kPacked,
+                                           packed, labels2);
+    REQUIRE(labels1.str() == labels2.str());
+
+    size_t image_size = Images::ReadPackedHeader(packed);
+    Image packed_image;
+    Image ascii_image;
+    for (size_t index = 0; index < image_count; index++) {
+      REQUIRE(Images::ReadPackedImage(packed, image_size, packed_image));
+      REQUIRE(Images::ReadImage(images1, ascii_image));
+      REQUIRE(packed_image == ascii_image);
+    }
+  }
+}
@@ -0,0 +1,118 @@
+#include <core/evaluation_report.h>
+#include <core/pipelined_evaluator.h>
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <sstream>
+
+using naivebayes::Classifier;
+using naivebayes::EvaluationReport;
+using naivebayes::Images;
+using naivebayes::PipelinedEvaluator;
+
+TEST_CASE("Evaluation report") {
+  EvaluationReport report({0, 1, 2}, 2, 3, 1);
+
+  // Predicted 0 with a margin of 2.5; class 2 ranks second.
+  report.AddScores(2, {-1, -5, -3.5});
+  // Predicted 1 with a margin of .5; correct.
+  report.AddScores(1, {-2, -1.5, -9});
+  // Ties go to the earlier class, so this predicts 0 with a margin of 0.
+  report.AddScores(1, {-1, -1, -4});
+
+  SECTION("Accuracies") {
+    REQUIRE(report.GetImageCount() == 3);
+    REQUIRE(report.GetAccuracy() == Approx(1.0 / 3));
+    REQUIRE(report.GetTopKAccuracy(2) == Approx(1));
+    REQUIRE_THROWS_AS(report.GetTopKAccuracy(3), std::invalid_argument);
+  }
+
+  SECTION("Confusion matrix, precision and recall") {
+    REQUIRE(report.GetConfusionCount(2, 0) == 1);
+    REQUIRE(report.GetConfusionCount(1, 1) == 1);
+    REQUIRE(report.GetConfusionCount(1, 0) == 1);
+    REQUIRE(report.GetPrecision(0) == 0);
+    REQUIRE(report.GetPrecision(1) == 1);
+    REQUIRE(report.GetRecall(1) == Approx(.5));
+    REQUIRE(report.GetRecall(2) == 0);
+  }
+
+  SECTION("Margin histogram") {
+    // The last bin also counts the margin of 2.5.
+    REQUIRE(report.GetMarginHistogram() == std::vector<size_t>({2, 0, 1}));
+  }
+
+  SECTION("Unknown labels count as misclassified") {
+    report.AddScores(7, {-1, -2, -3});
+    REQUIRE(report.GetImageCount() == 4);
+    REQUIRE(report.GetUnknownLabelCount() == 1);
+    REQUIRE(report.GetAccuracy() == Approx(.25));
+  }
+
+  SECTION("Merging adds every count") {
+    EvaluationReport other({0, 1, 2}, 2, 3, 1);
+    other.AddScores(0, {-1, -2, -3});
+    report.Merge(other);
+
+    REQUIRE(report.GetImageCount() == 4);
+    REQUIRE(report.GetAccuracy() == Approx(.5));
+    REQUIRE(report.GetConfusionCount(0, 0) == 1);
+    REQUIRE(report.GetMarginHistogram() == std::vector<size_t>({2, 1, 1}));
+  }
+
+  SECTION("Merging different classes") {
+    EvaluationReport other({0, 1}, 2, 3, 1);
+    REQUIRE_THROWS_AS(report.Merge(other), std::invalid_argument);
+  }
+
+  SECTION("Mismatched scores") {
+    REQUIRE_THROWS_AS(report.AddScores(0, {-1, -2}), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Pipelined evaluation report") {
+  std::string folder =
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/";
+  Classifier classifier;
+  std::ifstream ifs1(folder + "savedmodeldata");
+  ifs1 >> classifier.model_;
+  classifier.ReadLabels(folder + "testlabels");
+
+  Images test_images;
+  std::ifstream ifs2(folder + "testimages");
+  ifs2 >> test_images;
+  double expected_accuracy = classifier.CalculateAccuracy(test_images);
+
+  std::ifstream images_stream1(folder + "testimages");
+  std::ifstream labels_stream1(folder + "testlabels");
+  EvaluationReport report =
+      PipelinedEvaluator(classifier, 1).Evaluate(images_stream1, labels_stream1);
+
+  SECTION("Matches the classifier") {
+    REQUIRE(report.GetImageCount() == test_images.Size());
+    REQUIRE(report.GetAccuracy() == Approx(expected_accuracy));
+    REQUIRE(report.GetTopKAccuracy(3) >= report.GetTopKAccuracy(2));
+    REQUIRE(report.GetTopKAccuracy(2) >= report.GetAccuracy());
+
+    size_t correct_count = 0;
+    for (size_t class_num : report.GetClasses()) {
+      correct_count += report.GetConfusionCount(class_num, class_num);
+    }
+    REQUIRE(correct_count ==
+            (size_t) (expected_accuracy * test_images.Size() + .5));
+  }
+
+  SECTION("Threads merge into the same report") {
+    std::ifstream images_stream2(folder + "testimages");
+    std::ifstream labels_stream2(folder + "testlabels");
+    EvaluationReport threaded_report = PipelinedEvaluator(classifier, 4, 7, 2)
+                                           .Evaluate(images_stream2,
+                                                     labels_stream2);
+
+    std::stringstream expected;
+    std::stringstream actual;
+    expected << report;
+    actual << threaded_report;
+    REQUIRE(actual.str() == expected.str());
+  }
+}
@@ -0,0 +1,251 @@
+#include <core/classifier.h>
+#include <core/input_file.h>
+
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#ifdef NAIVEBAYES_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef NAIVEBAYES_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+using naivebayes::Compression;
+using naivebayes::DecompressingStreambuf;
+using naivebayes::Images;
+using naivebayes::InputFile;
+
+std::string input_file_folder =
+    "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/";
+
+/**
+ * @return the whole content of a stream.
+ */
+std::string ReadAll(std::istream& is) {
+  return std::string(std::istreambuf_iterator<char>(is),
+                     std::istreambuf_iterator<char>());
+}
+
+TEST_CASE("Plain input files") {
+  SECTION("Reads like an ifstream") {
+    InputFile file(input_file_folder + "data/testlabels");
+    std::ifstream expected(input_file_folder + "data/testlabels");
+    REQUIRE(file.GetCompression() == Compression::kNone);
+    REQUIRE(ReadAll(file) == ReadAll(expected));
+  }
+
+  SECTION("Missing file") {
+    InputFile file("fes/dw.txt");
+    REQUIRE(file.fail());
+  }
+
+  SECTION("Stream buffer passes uncompressed data through") {
+    std::string content(1 << 20, '#');
+    content[12345] = ' ';
+    std::stringstream source(content);
+    DecompressingStreambuf buffer(source, Compression::kNone);
+    std::istream is(&buffer);
+    REQUIRE(ReadAll(is) == content);
+  }
+
+  SECTION("Stopping early") {
+    std::stringstream source(std::string(1 << 22, ' '));
+    DecompressingStreambuf buffer(source, Compression::kNone, 1);
+    std::istream is(&buffer);
+    REQUIRE(is.get() == ' ');
+  }
+}
+
+#ifdef NAIVEBAYES_HAVE_ZLIB
+
+/**
+ * Writes content to a gzip file in one or more members.
+ */
+void WriteGzip(const std::string& file_path, const std::string& content,
+               size_t members) {
+  std::remove(file_path.c_str());
+  size_t member_size = content.size() / members + 1;
+  for (size_t begin = 0; begin < content.size(); begin += member_size) {
+    gzFile file = gzopen(file_path.c_str(), "ab");
+    size_t size = std::min(member_size, content.size() - begin);
+    gzwrite(file, content.data() + begin, (unsigned) size);
+    gzclose(file);
+  }
+}
+
+TEST_CASE("Gzip input files") {
+  std::ifstream plain(input_file_folder + "data/testimages");
+  std::string content = ReadAll(plain);
+  std::string file_path = input_file_folder + "tests/data/testimages.gz";
+
+  SECTION("Parses the same images as the plain file") {
+    WriteGzip(file_path, content, 1);
+    InputFile file(file_path);
+    REQUIRE(file.GetCompression() == Compression::kGzip);
+
+    Images compressed_images;
+    file >> compressed_images;
+    Images plain_images;
+    std::stringstream plain_stream(content);
+    plain_stream >> plain_images;
+    REQUIRE(compressed_images.GetImages() == plain_images.GetImages());
+  }
+
+  SECTION("Concatenated members") {
+    WriteGzip(file_path, content, 3);
+    InputFile file(file_path);
+    REQUIRE(ReadAll(file) == content);
+  }
+
+  SECTION("Labels") {
+    std::ifstream labels(input_file_folder + "data/testlabels");
+    std::string labels_content = ReadAll(labels);
+    WriteGzip(file_path, labels_content, 1);
+
+    naivebayes::Classifier classifier;
+    classifier.ReadLabels(file_path);
+    REQUIRE(classifier.GetExpectedClasses().size() == 1000);
+  }
+
+  SECTION("Truncated file") {
+    WriteGzip(file_path, content, 1);
+    std::string compressed;
+    {
+      std::ifstream ifs(file_path, std::ios::binary);
+      compressed = ReadAll(ifs);
+    }
+    std::ofstream ofs(file_path, std::ios::binary);
+    ofs << compressed.substr(0, compressed.size() / 2);
+    ofs.close();
+
+    InputFile file(file_path);
+    REQUIRE_THROWS_AS(ReadAll(file), std::invalid_argument);
+  }
+
+  SECTION("Zero padding after the last member") {
+    WriteGzip(file_path, content, 2);
+    {
+      std::ofstream ofs(file_path, std::ios::binary | std::ios::app);
+      ofs << std::string(100000, '\0');
+    }
+    InputFile file(file_path);
+    REQUIRE(ReadAll(file) == content);
+  }
+
+  SECTION("Padding followed by other bytes") {
+    WriteGzip(file_path, content, 1);
+    {
+      std::ofstream ofs(file_path, std::ios::binary | std::ios::app);
+      ofs << std::string(100, '\0') << "junk";
+    }
+    InputFile file(file_path);
+    REQUIRE_THROWS_AS(ReadAll(file), std::invalid_argument);
+  }
+
+  std::remove(file_path.c_str());
+}
+
+#else
+
+TEST_CASE("Gzip input without zlib") {
+  std::string file_path = input_file_folder + "tests/data/testimages.gz";
+  {
+    std::ofstream ofs(file_path, std::ios::binary);
+    ofs << "\x1f\x8b compressed";
+  }
+
+  {
+    InputFile file(file_path);
+    REQUIRE(file.GetCompression() == Compression::kGzip);
+    REQUIRE_THROWS_AS(ReadAll(file), std::invalid_argument);
+  }
+  std::remove(file_path.c_str());
+}
+
+#endif
+
+#ifdef NAIVEBAYES_HAVE_ZSTD
+
+/**
+ * Writes content to a zstd file in one or more frames.
+ */
+void WriteZstd(const std::string& file_path, const std::string& content,
+               size_t frames) {
+  std::ofstream ofs(file_path, std::ios::binary);
+  size_t frame_size = content.size() / frames + 1;
+  for (size_t begin = 0; begin < content.size(); begin += frame_size) {
+    size_t size = std::min(frame_size, content.size() - begin);
+    std::string compressed(ZSTD_compressBound(size), '\0');
+    compressed.resize(ZSTD_compress(&compressed[0], compressed.size(),
+                                    content.data() + begin, size, 3));
+    ofs << compressed;
+  }
+}
+
+TEST_CASE("Zstd input files") {
+  std::ifstream plain(input_file_folder + "data/testimages");
+  std::string content = ReadAll(plain);
+  std::string file_path = input_file_folder + "tests/data/testimages.zst";
+
+  SECTION("Parses the same images as the plain file") {
+    WriteZstd(file_path, content, 1);
+    InputFile file(file_path);
+    REQUIRE(file.GetCompression() == Compression::kZstd);
+
+    Images compressed_images;
+    file >> compressed_images;
+    Images plain_images;
+    std::stringstream plain_stream(content);
+    plain_stream >> plain_images;
+    REQUIRE(compressed_images.GetImages() == plain_images.GetImages());
+  }
+
+  SECTION("Concatenated frames") {
+    WriteZstd(file_path, content, 3);
+    InputFile file(file_path);
+    REQUIRE(ReadAll(file) == content);
+  }
+
+  SECTION("Truncated file") {
+    WriteZstd(file_path, content, 1);
+    std::string compressed;
+    {
+      std::ifstream ifs(file_path, std::ios::binary);
+      compressed = ReadAll(ifs);
+    }
+    std::ofstream ofs(file_path, std::ios::binary);
+    ofs << compressed.substr(0, compressed.size() / 2);
+    ofs.close();
+
+    InputFile file(file_path);
+    REQUIRE_THROWS_AS(ReadAll(file), std::invalid_argument);
+  }
+
+  std::remove(file_path.c_str());
+}
+
+#else
+
+TEST_CASE("Zstd input without libzstd") {
+  std::string file_path = input_file_folder + "tests/data/testimages.zst";
+  {
+    std::ofstream ofs(file_path, std::ios::binary);
+    ofs << "\x28\xb5\x2f\xfd compressed";
+  }
+
+  {
+    InputFile file(file_path);
+    REQUIRE(file.GetCompression() == Compression::kZstd);
+    REQUIRE_THROWS_AS(ReadAll(file), std::invalid_argument);
+  }
+  std::remove(file_path.c_str());
+}
+
+#endif
@@ -0,0 +1,111 @@
+#include <core/bounded_queue.h>
+#include <core/pipelined_evaluator.h>
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+using naivebayes::BoundedQueue;
+using naivebayes::Classifier;
+using naivebayes::Images;
+using naivebayes::PipelinedEvaluator;
+
+std::string pipeline_model_file_path =
+    "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+    "savedmodeldata";
+std::string pipeline_images_file_path =
+    "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+    "testimages";
+std::string pipeline_labels_file_path =
+    "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+    "testlabels";
+
+TEST_CASE("Bounded queue") {
+  SECTION("Keeps order and capacity") {
+    BoundedQueue<size_t> queue(3);
+    for (size_t value = 0; value < 4; value++) {
+      REQUIRE(queue.TryPush(std::move(value)));
+    }
+    size_t extra = 4;
+    REQUIRE_FALSE(queue.TryPush(std::move(extra)));
+
+    for (size_t expected = 0; expected < 4; expected++) {
+      size_t value;
+      REQUIRE(queue.TryPop(value));
+      REQUIRE(value == expected);
+    }
+    size_t value;
+    REQUIRE_FALSE(queue.TryPop(value));
+  }
+
+  SECTION("Passes every element between threads") {
+    BoundedQueue<size_t> queue(8);
+    const size_t kCount = 100000;
+    std::thread producer([&]() {
+      for (size_t value = 1; value <= kCount; value++) {
+        queue.Push(std::move(value));
+      }
+    });
+
+    size_t sum = 0;
+    for (size_t index = 0; index < kCount; index++) {
+      size_t value;
+      queue.Pop(value);
+      sum += value;
+    }
+    producer.join();
+    REQUIRE(sum == kCount * (kCount + 1) / 2);
+  }
+}
+
+TEST_CASE("Pipelined accuracy matches sequential accuracy") {
+  Classifier classifier;
+  std::ifstream ifs1(pipeline_model_file_path);
+  ifs1 >> classifier.model_;
+  classifier.ReadLabels(pipeline_labels_file_path);
+
+  Images test_images;
+  std::ifstream ifs2(pipeline_images_file_path);
+  ifs2 >> test_images;
+  double expected_accuracy = classifier.CalculateAccuracy(test_images);
+
+  SECTION("One classifying thread") {
+    std::ifstream images_stream(pipeline_images_file_path);
+    std::ifstream labels_stream(pipeline_labels_file_path);
+    PipelinedEvaluator evaluator(classifier, 1);
+    REQUIRE(evaluator.CalculateAccuracy(images_stream, labels_stream) ==
+            Approx(expected_accuracy));
+    REQUIRE(evaluator.GetImageCount() == test_images.Size());
+  }
+
+  SECTION("Several threads and a partial last block") {
+    std::ifstream images_stream(pipeline_images_file_path);
+    std::ifstream labels_stream(pipeline_labels_file_path);
+    PipelinedEvaluator evaluator(classifier, 4, 7, 2);
+    REQUIRE(evaluator.CalculateAccuracy(images_stream, labels_stream) ==
+            Approx(expected_accuracy));
+    REQUIRE(evaluator.GetImageCount() == test_images.Size());
+  }
+
+  SECTION("Image of the wrong size") {
+    std::stringstream images_stream;
+    for (size_t row = 0; row < 28; row++) {
+      images_stream << std::string(28, ' ') << '\n';
+    }
+    images_stream << "   \n # \n   \n";
+    std::stringstream labels_stream("1 2\n");
+    PipelinedEvaluator evaluator(classifier, 2, 1);
+    REQUIRE_THROWS_AS(evaluator.CalculateAccuracy(images_stream, labels_stream),
+                      std::invalid_argument);
+  }
+
+  SECTION("Missing file") {
+    std::ifstream images_stream("fes/dw.txt");
+    std::ifstream labels_stream(pipeline_labels_file_path);
+    PipelinedEvaluator evaluator(classifier, 1);
+    REQUIRE_THROWS_AS(evaluator.CalculateAccuracy(images_stream, labels_stream),
+                      std::invalid_argument);
+  }
+}
@@ -0,0 +1,60 @@
+#include <core/classifier.h>
+#include <core/quantized_model.h>
+
+#include <catch2/catch.hpp>
+#include <fstream>
+
+using naivebayes::Classifier;
+using naivebayes::Image;
+using naivebayes::Images;
+using naivebayes::QuantizedModel;
+
+TEST_CASE("Quantized model matches the float classifier") {
+  Classifier classifier;
+  std::ifstream ifs1(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "savedmodeldata");
+  ifs1 >> classifier.model_;
+
+  classifier.ReadLabels(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "testlabels");
+
+  Images test_images;
+  std::ifstream ifs2(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "testimages");
+  ifs2 >> test_images;
+
+  double float_accuracy = classifier.CalculateAccuracy(test_images);
+  double float_bytes =
+      classifier.model_.GetProbabilities().size() * sizeof(double);
+
+  SECTION("16 bit") {
+    QuantizedModel quantized;
+    quantized.Calibrate(classifier.model_, test_images, 16);
+
+    REQUIRE(quantized.GetBits() == 16);
+    REQUIRE(quantized.CalculateAccuracy(
+                test_images, classifier.GetExpectedClasses()) ==
+            Approx(float_accuracy).margin(.005));
+    REQUIRE(float_bytes / quantized.GetFootprintBytes() > 3.9);
+  }
+
+  SECTION("8 bit") {
+    QuantizedModel quantized;
+    quantized.Calibrate(classifier.model_, test_images, 8);
+
+    REQUIRE(quantized.CalculateAccuracy(
+                test_images, classifier.GetExpectedClasses()) ==
+            Approx(float_accuracy).margin(.02));
+    REQUIRE(float_bytes / quantized.GetFootprintBytes() > 7.5);
+  }
+
+  SECTION("Scale larger than the bit width allows") {
+    QuantizedModel quantized;
+    double max_scale = QuantizedModel::GetMaxScale(classifier.model_, 8);
+    REQUIRE_THROWS_AS(quantized.Quantize(classifier.model_, 8, max_scale * 2),
+                      std::invalid_argument);
+  }
+}
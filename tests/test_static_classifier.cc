@@ -0,0 +1,52 @@
+#include <core/classifier.h>
+#include <core/static_classifier.h>
+
+#include <catch2/catch.hpp>
+#include <fstream>
+
+using naivebayes::Classifier;
+using naivebayes::Image;
+using naivebayes::Images;
+using naivebayes::StaticClassifier;
+
+// The test build compiles data/savedmodeldata into the static tables.
+TEST_CASE("Static classifier matches the loaded model") {
+  Classifier classifier;
+  std::ifstream ifs1(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "savedmodeldata");
+  ifs1 >> classifier.model_;
+
+  Images test_images;
+  std::ifstream ifs2(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "testimages");
+  ifs2 >> test_images;
+
+  REQUIRE(StaticClassifier::GetImageDimension() ==
+          classifier.model_.image_size_);
+  REQUIRE(StaticClassifier::GetNumClasses() == classifier.model_.num_classes_);
+
+  SECTION("Likelihood scores") {
+    for (size_t index = 0; index < classifier.model_.classes_.size(); index++) {
+      size_t class_num = classifier.model_.classes_[index];
+      REQUIRE(StaticClassifier::CalculateLikelihoodScore(
+                  index, test_images.GetImage(0)) ==
+              Approx(classifier.CalculateLikelihoodScore(
+                  class_num, test_images.GetImage(0))));
+    }
+  }
+
+  SECTION("Classifications") {
+    for (const Image& image : test_images.GetImages()) {
+      REQUIRE(StaticClassifier::ClassifyImage(image) ==
+              classifier.ClassifyImage(image));
+    }
+  }
+
+  SECTION("Image of the wrong size") {
+    Image image = {{' ', '#'}, {'#', ' '}};
+    REQUIRE_THROWS_AS(StaticClassifier::ClassifyImage(image),
+                      std::invalid_argument);
+  }
+}
@@ -0,0 +1,142 @@
+#include <core/stream_classifier.h>
+
+#include <catch2/catch.hpp>
+#include <fstream>
+#include <sstream>
+
+using naivebayes::Classifier;
+using naivebayes::Image;
+using naivebayes::ImageFormat;
+using naivebayes::Images;
+using naivebayes::StreamClassifier;
+
+TEST_CASE("Streaming classification") {
+  Classifier classifier;
+  std::ifstream ifs1(
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "savedmodeldata");
+  ifs1 >> classifier.model_;
+
+  std::string test_images_file_path =
+      "c:/Users/Andori/Cinder/my-projects/naivebayes-andrewson3107/data/"
+      "testimages";
+  Images test_images;
+  std::ifstream ifs2(test_images_file_path);
+  ifs2 >> test_images;
+
+  std::stringstream expected_output;
+  for (const Image& image : test_images.GetImages()) {
+    expected_output << classifier.ClassifyImage(image) << std::endl;
+  }
+
+  SECTION("Ascii images keep their order across threads and batches") {
+    std::ifstream image_stream(test_images_file_path);
+    std::stringstream output;
+    StreamClassifier stream_classifier(classifier, 3, 7, false);
+
+    REQUIRE(stream_classifier.ClassifyStream(image_stream, ImageFormat::kAscii,
+                                             output) == test_images.Size());
+    REQUIRE(output.str() == expected_output.str());
+  }
+
+  SECTION("Packed images match ascii images") {
+    std::stringstream packed;
+    Images::WritePackedHeader(packed, 28);
+    for (const Image& image : test_images.GetImages()) {
+      Images::WritePackedImage(packed, image);
+    }
+
+    std::stringstream output;
+    StreamClassifier stream_classifier(classifier, 2, 100, false);
+    stream_classifier.ClassifyStream(packed, ImageFormat::kPacked, output);
+    REQUIRE(output.str() == expected_output.str());
+  }
+
+  SECTION("Scores follow each label") {
+    std::stringstream image_stream;
+    for (const std::vector<char>& row : test_images.GetImage(0)) {
+      image_stream << std::string(row.begin(), row.end()) << std::endl;
+    }
+
+    std::stringstream output;
+    StreamClassifier stream_classifier(classifier, 1, 1, true);
+    stream_classifier.ClassifyStream(image_stream, ImageFormat::kAscii, output);
+
+    size_t label;
+    char separator;
+    output >> label;
+    output.get(separator);
+    REQUIRE(label == classifier.ClassifyImage(test_images.GetImage(0)));
+    REQUIRE(separator == '\t');
+
+    double score;
+    for (size_t class_num : classifier.model_.classes_) {
+      output >> score;
+      REQUIRE(score == Approx(classifier.CalculateLikelihoodScore(
+                                  class_num, test_images.GetImage(0)))
+                           .epsilon(1e-5));
+    }
+  }
+
+  SECTION("Stream without the packed header") {
+    std::stringstream not_packed("   \n # \n   \n");
+    std::stringstream output;
+    StreamClassifier stream_classifier(classifier, 1, 1, false);
+    REQUIRE_THROWS_AS(stream_classifier.ClassifyStream(
+                          not_packed, ImageFormat::kPacked, output),
+                      std::invalid_argument);
+  }
+
+  SECTION("Packed header sizes other than the model's") {
+    for (size_t image_size : {0, 10, 40}) {
+      std::stringstream packed;
+      Images::WritePackedHeader(packed, image_size);
+      packed << std::string(64, '\0');
+      std::stringstream output;
+      StreamClassifier stream_classifier(classifier, 2, 4, false);
+      REQUIRE_THROWS_AS(
+          stream_classifier.ClassifyStream(packed, ImageFormat::kPacked,
+                                           output),
+          std::invalid_argument);
+      REQUIRE(output.str().empty());
+    }
+  }
+
+  SECTION("Ascii image larger than the model") {
+    std::stringstream image_stream;
+    for (size_t row = 0; row < 30; row++) {
+      image_stream << std::string(30, '#') << std::endl;
+    }
+
+    std::stringstream output;
+    StreamClassifier stream_classifier(classifier, 2, 4, false);
+    REQUIRE_THROWS_AS(stream_classifier.ClassifyStream(
+                          image_stream, ImageFormat::kAscii, output),
+                      std::invalid_argument);
+  }
+}
+
+TEST_CASE("Reading a packed image without pixels") {
+  std::stringstream packed;
+  Image image;
+  REQUIRE_THROWS_AS(Images::ReadPackedImage(packed, 0, image),
+                    std::invalid_argument);
+}
+
+TEST_CASE("Packing image rows into words") {
+  SECTION("Each shaded pixel sets its column's bit") {
+    Image image = {{'#', ' ', ' '}, {' ', ' ', ' '}, {' ', '+', '#'}};
+    uint64_t packed_rows[3];
+    Images::PackImage(image, packed_rows);
+    REQUIRE(packed_rows[0] == 1);
+    REQUIRE(packed_rows[1] == 0);
+    REQUIRE(packed_rows[2] == 6);
+  }
+
+  SECTION("Rows wider than a word") {
+    Image image = {std::vector<char>(65, '#')};
+    uint64_t packed_rows[1];
+    REQUIRE_THROWS_AS(Images::PackImage(image, packed_rows),
+                      std::invalid_argument);
+  }
+}